@@ -0,0 +1,158 @@
+#include "BandedFloydSolver.h"
+#include "HardwareCounters.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+namespace
+{
+	//waits until all threads have come to it, can be used again right away
+	class Barrier
+	{
+	public:
+		explicit Barrier(int threadsCount)
+		{
+			this->threadsCount = threadsCount;
+			waitingCount = 0;
+			generation = 0;
+		}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			int currentGeneration = generation;
+			if (++waitingCount == threadsCount)
+			{
+				waitingCount = 0;
+				generation++;
+				everyoneCame.notify_all();
+				return;
+			}
+			everyoneCame.wait(lock, [this, currentGeneration]() { return generation != currentGeneration; });
+		}
+
+	private:
+		std::mutex mutex;
+		std::condition_variable everyoneCame;
+		int threadsCount;
+		int waitingCount;
+		int generation;
+	};
+}
+
+BandedFloydSolver::BandedFloydSolver(int** adjacencyMatrix, int verticesCount, int threadsCount,
+	MatrixAllocator::Pages pages, bool isFirstTouchByOwner)
+	: FloydSolver(adjacencyMatrix, verticesCount)
+{
+	this->threadsCount = threadsCount;
+	this->pages = pages;
+	this->isFirstTouchByOwner = isFirstTouchByOwner;
+	this->actualPages = MatrixAllocator::NormalPages;
+	this->remoteBytesCount = -1;
+	this->tlbMissesCount = -1;
+	this->remoteAccessesCount = -1;
+}
+
+int BandedFloydSolver::bandStart(int band, int bandsCount) const
+{
+	return (int)((long long)band * verticesCount / bandsCount);
+}
+
+void BandedFloydSolver::solve()
+{
+	int processorsCount = (int)std::thread::hardware_concurrency();
+	int bandsCount = threadsCount > 0 ? threadsCount : processorsCount;
+	if (bandsCount > verticesCount)
+		bandsCount = verticesCount;
+	if (bandsCount < 1)
+		bandsCount = 1;
+
+	//pages of the matrices made by constructor are placed already, so they're given back
+	//before new ones are made (which nobody has touched yet) and filled up from adjacency matrix again
+	MatrixAllocator::release(distancesMatrix);
+	MatrixAllocator::release(predecessorsMatrix);
+	distancesMatrix = MatrixAllocator::allocate(verticesCount, pages);
+	predecessorsMatrix = MatrixAllocator::allocate(verticesCount, pages);
+	int** distances = distancesMatrix;
+	int** predecessors = predecessorsMatrix;
+	actualPages = MatrixAllocator::getPages(distances);
+	//initial values as FloydSolver sets them
+	auto fillRows = [&](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			for (int j = 0; j < verticesCount; j++)
+			{
+				distances[i][j] = adjacencyMatrix[i][j];
+				predecessors[i][j] = adjacencyMatrix[i][j] != infinity ? i : -1;
+			}
+		}
+	};
+	if (!isFirstTouchByOwner)
+		fillRows(0, verticesCount);
+
+	std::vector<int> nodes(bandsCount, -1);
+	Barrier barrier(bandsCount);
+	HardwareCounters counters;
+	counters.start();
+	auto worker = [&](int band)
+	{
+		//while the thread stays on one processor its node stays the same
+		if (band < processorsCount)
+			MatrixAllocator::pinCurrentThread(band);
+		nodes[band] = MatrixAllocator::getCurrentNode();
+		int first = bandStart(band, bandsCount);
+		int last = bandStart(band + 1, bandsCount);
+		if (isFirstTouchByOwner)
+			fillRows(first, last);
+		barrier.wait();
+
+		for (int k = 0; k < verticesCount; k++)
+		{
+			const int* distancesK = distances[k];
+			const int* predecessorsK = predecessors[k];
+			for (int i = first; i < last; i++)
+			{
+				int distanceIK = distances[i][k];
+				//row k is being read by everyone, and without negative cycles it doesn't change on iteration k
+				if (i == k || distanceIK == infinity)
+					continue;
+				int* distancesI = distances[i];
+				int* predecessorsI = predecessors[i];
+				for (int j = 0; j < verticesCount; j++)
+				{
+					if (distancesK[j] != infinity && distanceIK + distancesK[j] < distancesI[j])
+					{
+						distancesI[j] = distanceIK + distancesK[j];
+						predecessorsI[j] = predecessorsK[j];
+					}
+				}
+			}
+			barrier.wait();
+		}
+	};
+	//the calling thread only waits, so pinning doesn't stick to it
+	std::vector<std::thread> threads;
+	for (int band = 0; band < bandsCount; band++)
+		threads.push_back(std::thread(worker, band));
+	for (unsigned int t = 0; t < threads.size(); t++)
+		threads[t].join();
+	counters.stop();
+	tlbMissesCount = counters.tlbMissesCount;
+	remoteAccessesCount = counters.remoteAccessesCount;
+
+	//where the pages of every band have actually landed.
+	//a page on the border of two bands (or a huge page holding several bands) belongs to one of them only
+	remoteBytesCount = 0;
+	for (int band = 0; band < bandsCount && remoteBytesCount >= 0; band++)
+	{
+		int first = bandStart(band, bandsCount);
+		int last = bandStart(band + 1, bandsCount);
+		long long distancesBytes = MatrixAllocator::countBytesOutsideNode(distances, first, last, nodes[band]);
+		long long predecessorsBytes = MatrixAllocator::countBytesOutsideNode(predecessors, first, last, nodes[band]);
+		remoteBytesCount = distancesBytes < 0 || predecessorsBytes < 0 ? -1 : remoteBytesCount + distancesBytes + predecessorsBytes;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "FloydSolver.h"
+#include "MatrixAllocator.h"
+#include <vector>
+
+//Floyd algorithm with rows split into bands, one band per thread, for the whole run.
+//every thread is pinned to its own processor and is the first to write its band of the
+//matrices, so the band's pages are placed on the NUMA node of the thread that works on it.
+//matrices can be backed by huge pages, so the V^3 sweep doesn't thrash the TLB.
+//on iteration k everyone reads row k and updates only its own rows, then waits for others.
+//it's the only engine placing pages by their owners: Graph and other engines fill their matrices
+//up from the thread that constructs them, so all their pages land on that thread's node.
+//solve() gives the matrices filled by constructor back and makes them again, so there's never a second pair.
+class BandedFloydSolver : public FloydSolver
+{
+public:
+	//threadsCount 0 means all hardware threads.
+	//isFirstTouchByOwner = false fills the matrices up from the calling thread (as a plain new would),
+	//to see what the placement gives
+	BandedFloydSolver(int** adjacencyMatrix, int verticesCount, int threadsCount = 0,
+		MatrixAllocator::Pages pages = MatrixAllocator::TransparentHugePages, bool isFirstTouchByOwner = true);
+
+	virtual void solve();
+
+	int threadsCount;
+	MatrixAllocator::Pages pages;
+	bool isFirstTouchByOwner;
+
+	//what the last solve() has got, -1 where the system can't tell.
+	//pages matrices have really got (the system may refuse huge ones)
+	MatrixAllocator::Pages actualPages;
+	//bytes of bands placed on other nodes than the node of their thread
+	long long remoteBytesCount;
+	//processor counters of the sweep
+	long long tlbMissesCount;
+	long long remoteAccessesCount;
+
+private:
+	//first row of the band, band equal to count of bands gives the end
+	int bandStart(int band, int bandsCount) const;
+};
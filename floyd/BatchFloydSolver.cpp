@@ -0,0 +1,218 @@
+#include "BatchFloydSolver.h"
+#include "FloydSolver.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+//SSE2 is there on every x64 processor, others get the plain loop
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	//relaxes interleaved row i of a group through vertice k (rows i and k are never the same).
+	//lanes are independent graphs, so they're all done by the same instructions without branches
+	void relaxRow(int* distancesI, int* predecessorsI, const int* distancesK, const int* predecessorsK, int k, int size)
+	{
+		//column k of row i doesn't change on iteration k either, so it's taken once
+		int distancesIK[BATCH_LANES];
+		for (int lane = 0; lane < BATCH_LANES; lane++)
+			distancesIK[lane] = distancesI[k * BATCH_LANES + lane];
+#ifdef BATCH_SSE2
+		//4 lanes in one register
+		const __m128i infinities = _mm_set1_epi32(infinity);
+		__m128i vectorsIK[BATCH_LANES / 4];
+		__m128i isInfiniteIK[BATCH_LANES / 4];
+		for (int part = 0; part < BATCH_LANES / 4; part++)
+		{
+			vectorsIK[part] = _mm_loadu_si128((const __m128i*)(distancesIK + part * 4));
+			isInfiniteIK[part] = _mm_cmpeq_epi32(vectorsIK[part], infinities);
+		}
+		for (int cell = 0; cell < size * BATCH_LANES; cell += BATCH_LANES)
+		{
+			for (int part = 0; part < BATCH_LANES / 4; part++)
+			{
+				int offset = cell + part * 4;
+				__m128i distanceKJ = _mm_loadu_si128((const __m128i*)(distancesK + offset));
+				__m128i distanceIJ = _mm_loadu_si128((const __m128i*)(distancesI + offset));
+				__m128i predecessorKJ = _mm_loadu_si128((const __m128i*)(predecessorsK + offset));
+				__m128i predecessorIJ = _mm_loadu_si128((const __m128i*)(predecessorsI + offset));
+				//adding infinity wraps around, such lanes are thrown away
+				__m128i sum = _mm_add_epi32(vectorsIK[part], distanceKJ);
+				__m128i isInfinite = _mm_or_si128(isInfiniteIK[part], _mm_cmpeq_epi32(distanceKJ, infinities));
+				__m128i isBetter = _mm_andnot_si128(isInfinite, _mm_cmplt_epi32(sum, distanceIJ));
+				distanceIJ = _mm_or_si128(_mm_and_si128(isBetter, sum), _mm_andnot_si128(isBetter, distanceIJ));
+				predecessorIJ = _mm_or_si128(_mm_and_si128(isBetter, predecessorKJ), _mm_andnot_si128(isBetter, predecessorIJ));
+				_mm_storeu_si128((__m128i*)(distancesI + offset), distanceIJ);
+				_mm_storeu_si128((__m128i*)(predecessorsI + offset), predecessorIJ);
+			}
+		}
+#else
+		for (int cell = 0; cell < size * BATCH_LANES; cell += BATCH_LANES)
+		{
+			for (int lane = 0; lane < BATCH_LANES; lane++)
+			{
+				int distanceIK = distancesIK[lane];
+				int distanceKJ = distancesK[cell + lane];
+				//the sum is made in unsigned, so adding infinity wraps instead of overflowing. It's thrown away anyway
+				int sum = (int)((unsigned int)distanceIK + (unsigned int)distanceKJ);
+				bool isBetter = (distanceIK != infinity) & (distanceKJ != infinity) & (sum < distancesI[cell + lane]);
+				distancesI[cell + lane] = isBetter ? sum : distancesI[cell + lane];
+				predecessorsI[cell + lane] = isBetter ? predecessorsK[cell + lane] : predecessorsI[cell + lane];
+			}
+		}
+#endif
+	}
+}
+
+BatchFloydSolver::BatchFloydSolver()
+{
+}
+
+int BatchFloydSolver::addGraph(int** adjacencyMatrix, int verticesCount)
+{
+	adjacencyMatrices.push_back(adjacencyMatrix);
+	verticesCounts.push_back(verticesCount);
+	resultOffsets.push_back(0);
+	return (int)adjacencyMatrices.size() - 1;
+}
+
+void BatchFloydSolver::clear()
+{
+	adjacencyMatrices.clear();
+	verticesCounts.clear();
+	resultOffsets.clear();
+	results.clear();
+	order.clear();
+}
+
+int BatchFloydSolver::getGraphsCount() const
+{
+	return (int)adjacencyMatrices.size();
+}
+
+int BatchFloydSolver::getVerticesCount(int graph) const
+{
+	return verticesCounts[graph];
+}
+
+const int* BatchFloydSolver::getDistances(int graph) const
+{
+	return results.data() + resultOffsets[graph];
+}
+
+const int* BatchFloydSolver::getPredecessors(int graph) const
+{
+	return results.data() + resultOffsets[graph] + (size_t)verticesCounts[graph] * verticesCounts[graph];
+}
+
+void BatchFloydSolver::getPath(int graph, int start, int finish, std::vector<int>& path) const
+{
+	int verticesCount = verticesCounts[graph];
+	buildPath(getPredecessors(graph) + (size_t)start * verticesCount, start, finish, verticesCount, path);
+}
+
+void BatchFloydSolver::solve()
+{
+	int graphsCount = getGraphsCount();
+	//results of all graphs in one block
+	size_t size = 0;
+	for (int g = 0; g < graphsCount; g++)
+	{
+		resultOffsets[g] = size;
+		size += 2 * (size_t)verticesCounts[g] * verticesCounts[g];
+	}
+	results.resize(size);
+
+	//graphs of similar size go together, so there's less padding
+	order.resize(graphsCount);
+	for (int g = 0; g < graphsCount; g++)
+		order[g] = g;
+	std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return verticesCounts[a] < verticesCounts[b]; });
+
+	int groupsCount = (graphsCount + BATCH_LANES - 1) / BATCH_LANES;
+	int threadsCount = (int)std::thread::hardware_concurrency();
+	if (threadsCount > groupsCount)
+		threadsCount = groupsCount;
+	if (threadsCount < 1)
+		threadsCount = 1;
+	if ((int)workspaces.size() < threadsCount)
+		workspaces.resize(threadsCount);
+
+	//every thread takes groups one by one with its own workspace
+	std::atomic<int> nextGroup(0);
+	parallelFor(threadsCount, [this, groupsCount, &nextGroup](int thread)
+	{
+		for (int group = nextGroup++; group < groupsCount; group = nextGroup++)
+			solveGroup(group, workspaces[thread]);
+	}, threadsCount);
+}
+
+void BatchFloydSolver::solveGroup(int group, Workspace& workspace)
+{
+	int first = group * BATCH_LANES;
+	int lanesCount = std::min(BATCH_LANES, (int)order.size() - first);
+	//graphs are sorted, so the last one is the biggest
+	int size = verticesCounts[order[first + lanesCount - 1]];
+	size_t cellsCount = (size_t)size * size * BATCH_LANES;
+	//keeps capacity, so the pool stops growing after the first big group
+	workspace.distances.assign(cellsCount, infinity);
+	workspace.predecessors.assign(cellsCount, -1);
+	int* distances = workspace.distances.data();
+	int* predecessors = workspace.predecessors.data();
+
+	//interleaving: initial values as FloydSolver sets them, padding stays unreachable
+	for (int lane = 0; lane < lanesCount; lane++)
+	{
+		int graph = order[first + lane];
+		int verticesCount = verticesCounts[graph];
+		int** adjacency = adjacencyMatrices[graph];
+		for (int i = 0; i < verticesCount; i++)
+		{
+			for (int j = 0; j < verticesCount; j++)
+			{
+				size_t cell = ((size_t)i * size + j) * BATCH_LANES + lane;
+				distances[cell] = adjacency[i][j];
+				predecessors[cell] = adjacency[i][j] != infinity ? i : -1;
+			}
+		}
+	}
+
+	for (int k = 0; k < size; k++)
+	{
+		const int* distancesK = distances + (size_t)k * size * BATCH_LANES;
+		const int* predecessorsK = predecessors + (size_t)k * size * BATCH_LANES;
+		for (int i = 0; i < size; i++)
+		{
+			//without negative cycles row k doesn't change on iteration k
+			if (i == k)
+				continue;
+			relaxRow(distances + (size_t)i * size * BATCH_LANES, predecessors + (size_t)i * size * BATCH_LANES,
+				distancesK, predecessorsK, k, size);
+		}
+	}
+
+	//de-interleaving to the arena
+	for (int lane = 0; lane < lanesCount; lane++)
+	{
+		int graph = order[first + lane];
+		int verticesCount = verticesCounts[graph];
+		int* resultDistances = results.data() + resultOffsets[graph];
+		int* resultPredecessors = resultDistances + (size_t)verticesCount * verticesCount;
+		for (int i = 0; i < verticesCount; i++)
+		{
+			for (int j = 0; j < verticesCount; j++)
+			{
+				size_t cell = ((size_t)i * size + j) * BATCH_LANES + lane;
+				resultDistances[i * verticesCount + j] = distances[cell];
+				resultPredecessors[i * verticesCount + j] = predecessors[cell];
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+
+//solves lots of small independent graphs (tens of vertices each) at once.
+//graphs are sorted by size and taken in groups of BATCH_LANES; matrices of a group are
+//interleaved cell by cell, so one SIMD instruction does the same step for all graphs
+//of the group, one lane for one graph. Smaller graphs of a group are padded
+//with unreachable vertices. Workspaces are kept between solve() calls, and all results
+//are stored one after another in a single arena.
+//results are the same as of DenseFloydSolver for every graph without negative cycles.
+//a multiple of 4, the count of ints in SSE register
+#define BATCH_LANES 8
+
+class BatchFloydSolver
+{
+public:
+	BatchFloydSolver();
+
+	//adds graph to the batch and returns its index. Matrix isn't copied, it should live until solve()
+	int addGraph(int** adjacencyMatrix, int verticesCount);
+	//forgets all graphs, but keeps memory for the next batch
+	void clear();
+	int getGraphsCount() const;
+
+	//solves every graph added so far, groups go in parallel
+	void solve();
+
+	int getVerticesCount(int graph) const;
+	//verticesCount x verticesCount row by row, the same meaning as matrices of FloydSolver
+	const int* getDistances(int graph) const;
+	const int* getPredecessors(int graph) const;
+	//constructs path between start and finish vertices of the graph, empty if there's none
+	void getPath(int graph, int start, int finish, std::vector<int>& path) const;
+
+private:
+	//interleaved distances and predecessors of one group: cell (i, j) of lane l is at (i * size + j) * BATCH_LANES + l
+	struct Workspace
+	{
+		std::vector<int> distances;
+		std::vector<int> predecessors;
+	};
+
+	std::vector<int**> adjacencyMatrices;
+	std::vector<int> verticesCounts;
+	//where distances of every graph start in results, predecessors follow them
+	std::vector<size_t> resultOffsets;
+	std::vector<int> results;
+
+	//graphs sorted by size, every BATCH_LANES of them make a group
+	std::vector<int> order;
+	//one per thread, reused by every group and every solve()
+	std::vector<Workspace> workspaces;
+
+	void solveGroup(int group, Workspace& workspace);
+};
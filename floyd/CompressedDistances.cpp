@@ -0,0 +1,146 @@
+#include "CompressedDistances.h"
+#include <string.h>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+//the same check as in BatchFloydSolver, SSE2 is there on every x64 processor
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMPRESSED_SSE2
+#include <emmintrin.h>
+#endif
+
+CompressedDistances::CompressedDistances(int** distancesMatrix, int verticesCount)
+{
+	this->verticesCount = verticesCount;
+	this->blocksPerRow = (verticesCount + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK;
+	blocks.resize((size_t)verticesCount * blocksPerRow);
+
+	//first pass finds bases and widths, so we know how many words there will be
+	size_t wordsCount = 0;
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int b = 0; b < blocksPerRow; b++)
+		{
+			int start = b * COMPRESSED_BLOCK;
+			int end = start + COMPRESSED_BLOCK < verticesCount ? start + COMPRESSED_BLOCK : verticesCount;
+			Block& block = blocks[(size_t)i * blocksPerRow + b];
+			bool hasFinite = false;
+			int minimum = 0, maximum = 0;
+			block.hasInfinity = 0;
+			for (int j = start; j < end; j++)
+			{
+				int value = distancesMatrix[i][j];
+				if (value == infinity)
+				{
+					block.hasInfinity = 1;
+					continue;
+				}
+				if (!hasFinite || value < minimum)
+					minimum = value;
+				if (!hasFinite || value > maximum)
+					maximum = value;
+				hasFinite = true;
+			}
+			//the biggest code is either the biggest difference or infinity right after it
+			unsigned long long biggestCode = hasFinite ? (unsigned long long)((long long)maximum - minimum) : 0;
+			if (hasFinite && block.hasInfinity)
+				biggestCode++;
+			int width = 0;
+			while (width < 32 && (biggestCode >> width) != 0)
+				width++;
+			block.base = minimum;
+			block.width = (unsigned char)width;
+			//a block of COMPRESSED_BLOCK values takes exactly width words
+			block.offset = (unsigned int)wordsCount;
+			wordsCount += width;
+		}
+	}
+
+	words.assign(wordsCount + 1, 0);
+	unsigned char* bytes = (unsigned char*)words.data();
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int b = 0; b < blocksPerRow; b++)
+		{
+			const Block& block = blocks[(size_t)i * blocksPerRow + b];
+			if (block.width == 0)
+				continue;
+			unsigned int mask = (unsigned int)((1ull << block.width) - 1);
+			int start = b * COMPRESSED_BLOCK;
+			int end = start + COMPRESSED_BLOCK < verticesCount ? start + COMPRESSED_BLOCK : verticesCount;
+			for (int j = start; j < end; j++)
+			{
+				int value = distancesMatrix[i][j];
+				unsigned int code = value == infinity ? mask : (unsigned int)value - (unsigned int)block.base;
+				size_t bit = (size_t)block.offset * 64 + (size_t)(j - start) * block.width;
+				//values overlap bytes, so they're or-ed into 8 bytes read the same way get does
+				unsigned long long word;
+				memcpy(&word, bytes + bit / 8, 8);
+				word |= (unsigned long long)code << (bit & 7);
+				memcpy(bytes + bit / 8, &word, 8);
+			}
+		}
+	}
+}
+
+int CompressedDistances::get(int i, int j) const
+{
+	const Block& block = blocks[(size_t)i * blocksPerRow + j / COMPRESSED_BLOCK];
+	unsigned int mask = (unsigned int)((1ull << block.width) - 1);
+	size_t bit = (size_t)block.offset * 64 + (size_t)(j % COMPRESSED_BLOCK) * block.width;
+	//up to 7 bits of shift and 32 bits of value are always inside 8 bytes
+	unsigned long long word;
+	memcpy(&word, (const unsigned char*)words.data() + bit / 8, 8);
+	unsigned int code = (unsigned int)(word >> (bit & 7)) & mask;
+	if (block.hasInfinity && code == mask)
+		return infinity;
+	return (int)((unsigned int)block.base + code);
+}
+
+void CompressedDistances::getRow(int i, int* output) const
+{
+	const unsigned char* bytes = (const unsigned char*)words.data();
+	unsigned int codes[COMPRESSED_BLOCK];
+	for (int b = 0; b < blocksPerRow; b++)
+	{
+		const Block& block = blocks[(size_t)i * blocksPerRow + b];
+		int start = b * COMPRESSED_BLOCK;
+		int count = start + COMPRESSED_BLOCK < verticesCount ? COMPRESSED_BLOCK : verticesCount - start;
+		int* values = output + start;
+		unsigned int width = block.width;
+		unsigned int mask = (unsigned int)((1ull << width) - 1);
+		//codes don't depend on each other, so their reads go in parallel
+		const unsigned char* blockBytes = bytes + (size_t)block.offset * 8;
+		for (int n = 0; n < count; n++)
+		{
+			unsigned int bit = n * width;
+			unsigned long long word;
+			memcpy(&word, blockBytes + bit / 8, 8);
+			codes[n] = (unsigned int)(word >> (bit & 7)) & mask;
+		}
+		//codes to values: base is added, and the reserved code becomes infinity
+		int n = 0;
+#ifdef COMPRESSED_SSE2
+		const __m128i bases = _mm_set1_epi32(block.base);
+		const __m128i infinities = _mm_set1_epi32(infinity);
+		//without infinity in the block no code is compared equal
+		const __m128i infinityCodes = _mm_set1_epi32(block.hasInfinity ? (int)mask : -1);
+		for (; n + 4 <= count; n += 4)
+		{
+			__m128i code = _mm_loadu_si128((const __m128i*)(codes + n));
+			__m128i isInfinite = _mm_cmpeq_epi32(code, infinityCodes);
+			__m128i value = _mm_add_epi32(code, bases);
+			value = _mm_or_si128(_mm_and_si128(isInfinite, infinities), _mm_andnot_si128(isInfinite, value));
+			_mm_storeu_si128((__m128i*)(values + n), value);
+		}
+#endif
+		for (; n < count; n++)
+			values[n] = block.hasInfinity && codes[n] == mask ? infinity : (int)((unsigned int)block.base + codes[n]);
+	}
+}
+
+size_t CompressedDistances::getBytesCount() const
+{
+	return blocks.size() * sizeof(Block) + words.size() * sizeof(unsigned long long);
+}
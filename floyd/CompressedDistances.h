@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+
+//values in one block
+#define COMPRESSED_BLOCK 64
+
+//read-only copy of solved distances which takes several times less memory than the matrix.
+//every row is cut into blocks of COMPRESSED_BLOCK values, a block keeps its minimum as a base
+//and the rest as differences from it packed with as few bits as its biggest difference needs.
+//if there's infinity in a block, the code of all ones is reserved for it.
+//any value is got in O(1) (one unaligned read and a shift), and whole rows are decoded block by block
+class CompressedDistances
+{
+public:
+	CompressedDistances(int** distancesMatrix, int verticesCount);
+
+	//distance from i to j, infinity (INT_MAX) if there's no path
+	int get(int i, int j) const;
+	//decodes the whole row to output, which must have verticesCount ints
+	void getRow(int i, int* output) const;
+
+	//memory taken by blocks and their bits
+	size_t getBytesCount() const;
+
+	int verticesCount;
+
+private:
+	struct Block
+	{
+		//the smallest finite value of the block
+		int base;
+		//where its bits start, in 64-bit words
+		unsigned int offset;
+		//bits per value, 0 if all values are the same
+		unsigned char width;
+		unsigned char hasInfinity;
+	};
+
+	int blocksPerRow;
+	std::vector<Block> blocks;
+	//bits of all blocks, little-endian, with an extra word at the end so reading 8 bytes never goes out of it
+	std::vector<unsigned long long> words;
+};
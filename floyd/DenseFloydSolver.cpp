@@ -0,0 +1,40 @@
+#include "DenseFloydSolver.h"
+#include "FloydWarshall.h"
+#include <limits.h>
+
+#define infinity INT_MAX
+
+DenseFloydSolver::DenseFloydSolver(int** adjacencyMatrix, int verticesCount)
+	: FloydSolver(adjacencyMatrix, verticesCount)
+{
+}
+
+void DenseFloydSolver::solve()
+{
+	//small graphs of some sizes have a version made for them while compiling
+	if (solveFixedSize(adjacencyMatrix, verticesCount, distancesMatrix, predecessorsMatrix))
+		return;
+
+	for (int k = 0; k < verticesCount; k++)
+	{
+		int* distancesK = distancesMatrix[k];
+		int* predecessorsK = predecessorsMatrix[k];
+		for (int i = 0; i < verticesCount; i++)
+		{
+			int distanceIK = distancesMatrix[i][k];
+			//there's nothing to improve in the whole row if i can't reach k
+			if (distanceIK == infinity)
+				continue;
+			int* distancesI = distancesMatrix[i];
+			int* predecessorsI = predecessorsMatrix[i];
+			for (int j = 0; j < verticesCount; j++)
+			{
+				if (distancesK[j] != infinity && distanceIK + distancesK[j] < distancesI[j])
+				{
+					distancesI[j] = distanceIK + distancesK[j];
+					predecessorsI[j] = predecessorsK[j];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "FloydSolver.h"
+
+//plain Floyd algorithm over the whole matrix, the reference for other engines
+class DenseFloydSolver : public FloydSolver
+{
+public:
+	DenseFloydSolver(int** adjacencyMatrix, int verticesCount);
+
+	virtual void solve();
+};
@@ -0,0 +1,532 @@
+#include "DistributedFloydSolver.h"
+#include "LocalTransport.h"
+#include "SocketTransport.h"
+#include <algorithm>
+#include <thread>
+#include <limits.h>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#define infinity INT_MAX
+
+namespace
+{
+	//a rectangle of distances and predecessors in one vector, the way it travels between workers:
+	//rows * columns distances first, then as many predecessors
+	struct Panel
+	{
+		int rows;
+		int columns;
+		std::vector<int> data;
+
+		void resize(int rows, int columns)
+		{
+			this->rows = rows;
+			this->columns = columns;
+			data.resize(2 * (size_t)rows * columns);
+		}
+		int* distances(int row) { return &data[(size_t)row * columns]; }
+		int* predecessors(int row) { return &data[((size_t)rows + row) * columns]; }
+	};
+
+	//one worker of the grid with its own tile
+	class TileWorker
+	{
+	public:
+		TileWorker(Transport& transport, int verticesCount, int gridRows, int gridColumns, const std::vector<int>& phaseStarts)
+			: transport(transport), phaseStarts(phaseStarts)
+		{
+			this->verticesCount = verticesCount;
+			this->gridRows = gridRows;
+			this->gridColumns = gridColumns;
+			gridRow = transport.getRank() / gridColumns;
+			gridColumn = transport.getRank() % gridColumns;
+			firstRow = rowBandStart(gridRow);
+			lastRow = rowBandStart(gridRow + 1);
+			firstColumn = columnBandStart(gridColumn);
+			lastColumn = columnBandStart(gridColumn + 1);
+			tile.resize(lastRow - firstRow, lastColumn - firstColumn);
+		}
+
+		int rowBandStart(int band) const { return (int)((long long)band * verticesCount / gridRows); }
+		int columnBandStart(int band) const { return (int)((long long)band * verticesCount / gridColumns); }
+		int rankOf(int row, int column) const { return row * gridColumns + column; }
+
+		//takes own tile of the initial matrices
+		void loadTile(int** distances, int** predecessors)
+		{
+			for (int i = 0; i < tile.rows; i++)
+			{
+				std::copy(distances[firstRow + i] + firstColumn, distances[firstRow + i] + lastColumn, tile.distances(i));
+				std::copy(predecessors[firstRow + i] + firstColumn, predecessors[firstRow + i] + lastColumn, tile.predecessors(i));
+			}
+		}
+
+		//puts a tile of given rank to result matrices
+		void storeTile(int rank, Panel& panel, int** distances, int** predecessors)
+		{
+			int row = rowBandStart(rank / gridColumns);
+			int column = columnBandStart(rank % gridColumns);
+			for (int i = 0; i < panel.rows; i++)
+			{
+				std::copy(panel.distances(i), panel.distances(i) + panel.columns, distances[row + i] + column);
+				std::copy(panel.predecessors(i), panel.predecessors(i) + panel.columns, predecessors[row + i] + column);
+			}
+		}
+
+		bool run()
+		{
+			int phasesCount = (int)phaseStarts.size() - 1;
+			if (phasesCount > 0 && !preparePhase(0))
+				return false;
+			for (int phase = 0; phase < phasesCount; phase++)
+			{
+				int start = phaseStarts[phase];
+				//rows and columns of this phase, either prepared by us or sent by their owners
+				if (isRowOwner(start))
+					rowPanel.data.swap(preparedRowPanel.data);
+				else if (!transport.receive(rankOf(rowBandOf(start), gridColumn), rowPanel.data))
+					return false;
+				if (isColumnOwner(start))
+					columnPanel.data.swap(preparedColumnPanel.data);
+				else if (!transport.receive(rankOf(gridRow, columnBandOf(start)), columnPanel.data))
+					return false;
+				rowPanel.rows = columnPanel.columns = phaseStarts[phase + 1] - start;
+				rowPanel.columns = tile.columns;
+				columnPanel.rows = tile.rows;
+
+				//the next phase needs its rows and columns as soon as possible,
+				//so they're updated first and sent before we update the rest
+				int nextEnd = phase + 2 < (int)phaseStarts.size() ? phaseStarts[phase + 2] : phaseStarts[phase + 1];
+				relaxTile(phase, nextEnd, true);
+				if (phase + 1 < phasesCount && !preparePhase(phase + 1))
+					return false;
+				relaxTile(phase, nextEnd, false);
+			}
+			return true;
+		}
+
+		Transport& transport;
+		Panel tile;
+
+	private:
+		const std::vector<int>& phaseStarts;
+		int verticesCount;
+		int gridRows;
+		int gridColumns;
+		int gridRow;
+		int gridColumn;
+		//tile borders in the whole matrix
+		int firstRow;
+		int lastRow;
+		int firstColumn;
+		int lastColumn;
+
+		//rows (phase x tile columns) and columns (tile rows x phase) of current phase
+		Panel rowPanel;
+		Panel columnPanel;
+		//the same for the next phase, if we're the owner of them
+		Panel preparedRowPanel;
+		Panel preparedColumnPanel;
+
+		int rowBandOf(int vertice) const
+		{
+			int band = (int)((long long)vertice * gridRows / verticesCount);
+			//integer division can put us one band off, fixing it
+			while (rowBandStart(band + 1) <= vertice)
+				band++;
+			while (rowBandStart(band) > vertice)
+				band--;
+			return band;
+		}
+		int columnBandOf(int vertice) const
+		{
+			int band = (int)((long long)vertice * gridColumns / verticesCount);
+			while (columnBandStart(band + 1) <= vertice)
+				band++;
+			while (columnBandStart(band) > vertice)
+				band--;
+			return band;
+		}
+		bool isRowOwner(int vertice) const { return rowBandOf(vertice) == gridRow; }
+		bool isColumnOwner(int vertice) const { return columnBandOf(vertice) == gridColumn; }
+
+		//closes diagonal block, updates and sends rows and columns of the phase we own
+		bool preparePhase(int phase)
+		{
+			int start = phaseStarts[phase];
+			int end = phaseStarts[phase + 1];
+			int size = end - start;
+			bool ownsRows = isRowOwner(start);
+			bool ownsColumns = isColumnOwner(start);
+			if (!ownsRows && !ownsColumns)
+				return true;
+
+			Panel diagonal;
+			int diagonalRank = rankOf(rowBandOf(start), columnBandOf(start));
+			if (ownsRows && ownsColumns)
+			{
+				//the diagonal block is ours. Closing it with plain Floyd algorithm
+				diagonal.resize(size, size);
+				for (int i = 0; i < size; i++)
+				{
+					std::copy(tile.distances(start - firstRow + i) + start - firstColumn, tile.distances(start - firstRow + i) + end - firstColumn, diagonal.distances(i));
+					std::copy(tile.predecessors(start - firstRow + i) + start - firstColumn, tile.predecessors(start - firstRow + i) + end - firstColumn, diagonal.predecessors(i));
+				}
+				for (int k = 0; k < size; k++)
+				{
+					for (int i = 0; i < size; i++)
+					{
+						int distanceIK = diagonal.distances(i)[k];
+						if (distanceIK == infinity)
+							continue;
+						for (int j = 0; j < size; j++)
+						{
+							int distanceKJ = diagonal.distances(k)[j];
+							if (distanceKJ != infinity && distanceIK + distanceKJ < diagonal.distances(i)[j])
+							{
+								diagonal.distances(i)[j] = distanceIK + distanceKJ;
+								diagonal.predecessors(i)[j] = diagonal.predecessors(k)[j];
+							}
+						}
+					}
+				}
+				for (int i = 0; i < size; i++)
+				{
+					std::copy(diagonal.distances(i), diagonal.distances(i) + size, tile.distances(start - firstRow + i) + start - firstColumn);
+					std::copy(diagonal.predecessors(i), diagonal.predecessors(i) + size, tile.predecessors(start - firstRow + i) + start - firstColumn);
+				}
+				//owners of phase rows are in our grid row, owners of phase columns - in our grid column
+				for (int column = 0; column < gridColumns; column++)
+				{
+					if (column != gridColumn)
+						transport.send(rankOf(gridRow, column), diagonal.data);
+				}
+				for (int row = 0; row < gridRows; row++)
+				{
+					if (row != gridRow)
+						transport.send(rankOf(row, gridColumn), diagonal.data);
+				}
+			}
+			else
+			{
+				if (!transport.receive(diagonalRank, diagonal.data))
+					return false;
+				diagonal.rows = diagonal.columns = size;
+			}
+
+			if (ownsRows)
+			{
+				//rows of the phase: path from phase vertice goes through the closed block to m
+				//and then by the old row of m
+				Panel oldRows;
+				oldRows.resize(size, tile.columns);
+				std::copy(tile.distances(start - firstRow), tile.distances(start - firstRow) + (size_t)size * tile.columns, oldRows.distances(0));
+				std::copy(tile.predecessors(start - firstRow), tile.predecessors(start - firstRow) + (size_t)size * tile.columns, oldRows.predecessors(0));
+				for (int i = 0; i < size; i++)
+				{
+					int* distancesI = tile.distances(start - firstRow + i);
+					int* predecessorsI = tile.predecessors(start - firstRow + i);
+					for (int m = 0; m < size; m++)
+					{
+						int distanceIM = diagonal.distances(i)[m];
+						if (m == i || distanceIM == infinity)
+							continue;
+						const int* distancesM = oldRows.distances(m);
+						const int* predecessorsM = oldRows.predecessors(m);
+						for (int j = 0; j < tile.columns; j++)
+						{
+							int column = firstColumn + j;
+							//the diagonal block is already done
+							if (column >= start && column < end)
+								continue;
+							if (distancesM[j] != infinity && distanceIM + distancesM[j] < distancesI[j])
+							{
+								distancesI[j] = distanceIM + distancesM[j];
+								predecessorsI[j] = predecessorsM[j];
+							}
+						}
+					}
+				}
+				preparedRowPanel.resize(size, tile.columns);
+				std::copy(tile.distances(start - firstRow), tile.distances(start - firstRow) + (size_t)size * tile.columns, preparedRowPanel.distances(0));
+				std::copy(tile.predecessors(start - firstRow), tile.predecessors(start - firstRow) + (size_t)size * tile.columns, preparedRowPanel.predecessors(0));
+				for (int row = 0; row < gridRows; row++)
+				{
+					if (row != gridRow)
+						transport.send(rankOf(row, gridColumn), preparedRowPanel.data);
+				}
+			}
+
+			if (ownsColumns)
+			{
+				//columns of the phase: old path to some m' and then through the closed block
+				preparedColumnPanel.resize(tile.rows, size);
+				for (int i = 0; i < tile.rows; i++)
+				{
+					int row = firstRow + i;
+					int* distancesI = tile.distances(i) + start - firstColumn;
+					int* predecessorsI = tile.predecessors(i) + start - firstColumn;
+					if (row < start || row >= end)
+					{
+						std::vector<int> oldDistances(distancesI, distancesI + size);
+						for (int m = 0; m < size; m++)
+						{
+							if (oldDistances[m] == infinity)
+								continue;
+							const int* distancesM = diagonal.distances(m);
+							const int* predecessorsM = diagonal.predecessors(m);
+							for (int j = 0; j < size; j++)
+							{
+								if (j != m && distancesM[j] != infinity && oldDistances[m] + distancesM[j] < distancesI[j])
+								{
+									distancesI[j] = oldDistances[m] + distancesM[j];
+									predecessorsI[j] = predecessorsM[j];
+								}
+							}
+						}
+					}
+					std::copy(distancesI, distancesI + size, preparedColumnPanel.distances(i));
+					std::copy(predecessorsI, predecessorsI + size, preparedColumnPanel.predecessors(i));
+				}
+				for (int column = 0; column < gridColumns; column++)
+				{
+					if (column != gridColumn)
+						transport.send(rankOf(gridRow, column), preparedColumnPanel.data);
+				}
+			}
+			return true;
+		}
+
+		//relaxes a row of tile through phase vertices for columns from first to last
+		void relaxRow(int i, int first, int last)
+		{
+			if (first >= last)
+				return;
+			int* distancesI = tile.distances(i);
+			int* predecessorsI = tile.predecessors(i);
+			const int* distancesIM = columnPanel.distances(i);
+			for (int m = 0; m < rowPanel.rows; m++)
+			{
+				int distanceIM = distancesIM[m];
+				if (distanceIM == infinity)
+					continue;
+				const int* distancesM = rowPanel.distances(m);
+				const int* predecessorsM = rowPanel.predecessors(m);
+				for (int j = first; j < last; j++)
+				{
+					if (distancesM[j] != infinity && distanceIM + distancesM[j] < distancesI[j])
+					{
+						distancesI[j] = distanceIM + distancesM[j];
+						predecessorsI[j] = predecessorsM[j];
+					}
+				}
+			}
+		}
+
+		//updates tile cells outside phase rows and columns.
+		//if 'next' is set - only those in rows or columns of the next phase (from phase end to nextEnd),
+		//otherwise all the others
+		void relaxTile(int phase, int nextEnd, bool next)
+		{
+			int start = phaseStarts[phase];
+			int end = phaseStarts[phase + 1];
+			//columns are in local indices: before the phase, the next phase, after both
+			int beforeEnd = std::max(0, std::min(tile.columns, start - firstColumn));
+			int nextStart = std::max(0, std::min(tile.columns, end - firstColumn));
+			int nextStop = std::max(0, std::min(tile.columns, nextEnd - firstColumn));
+			for (int i = 0; i < tile.rows; i++)
+			{
+				int row = firstRow + i;
+				if (row >= start && row < end)
+					continue;
+				bool isNextRow = row >= end && row < nextEnd;
+				if (next && isNextRow)
+				{
+					relaxRow(i, 0, beforeEnd);
+					relaxRow(i, nextStart, tile.columns);
+				}
+				else if (next)
+				{
+					relaxRow(i, nextStart, nextStop);
+				}
+				else if (!isNextRow)
+				{
+					relaxRow(i, 0, beforeEnd);
+					relaxRow(i, nextStop, tile.columns);
+				}
+			}
+		}
+	};
+}
+
+DistributedFloydSolver::DistributedFloydSolver(int** adjacencyMatrix, int verticesCount,
+	int gridRows, int gridColumns, int blockSize, WorkersKind workersKind)
+	: FloydSolver(adjacencyMatrix, verticesCount)
+{
+	//there's no point in more bands than vertices
+	this->gridRows = std::max(1, std::min(gridRows, verticesCount));
+	this->gridColumns = std::max(1, std::min(gridColumns, verticesCount));
+	this->blockSize = std::max(1, blockSize);
+	this->workersKind = workersKind;
+	this->isCompleted = false;
+
+	//a phase must not cross band borders, so its rows have one owner and its columns have one owner
+	for (int band = 0; band < this->gridRows; band++)
+		phaseStarts.push_back(rowBandStart(band));
+	for (int band = 0; band < this->gridColumns; band++)
+		phaseStarts.push_back(columnBandStart(band));
+	for (int start = 0; start < verticesCount; start += this->blockSize)
+		phaseStarts.push_back(start);
+	phaseStarts.push_back(verticesCount);
+	std::sort(phaseStarts.begin(), phaseStarts.end());
+	phaseStarts.erase(std::unique(phaseStarts.begin(), phaseStarts.end()), phaseStarts.end());
+}
+
+int DistributedFloydSolver::rowBandStart(int band) const
+{
+	return (int)((long long)band * verticesCount / gridRows);
+}
+
+int DistributedFloydSolver::columnBandStart(int band) const
+{
+	return (int)((long long)band * verticesCount / gridColumns);
+}
+
+void DistributedFloydSolver::solve()
+{
+	if (verticesCount == 0)
+	{
+		isCompleted = true;
+		return;
+	}
+#ifndef _WIN32
+	if (workersKind == Processes)
+	{
+		isCompleted = solveWithProcesses();
+		return;
+	}
+#endif
+	isCompleted = solveWithThreads();
+}
+
+bool DistributedFloydSolver::runWorker(Transport& transport)
+{
+	TileWorker worker(transport, verticesCount, gridRows, gridColumns, phaseStarts);
+	worker.loadTile(distancesMatrix, predecessorsMatrix);
+	bool isSucceeded = worker.run();
+
+	//gathering everything at rank 0
+	if (transport.getRank() != 0)
+	{
+		if (isSucceeded)
+			transport.send(0, worker.tile.data);
+		return isSucceeded;
+	}
+	if (!isSucceeded)
+		return false;
+	//other workers may still be reading their initial tiles, so we write only after they've sent results
+	std::vector<Panel> tiles(transport.getSize());
+	for (int rank = 1; rank < transport.getSize(); rank++)
+	{
+		int rows = rowBandStart(rank / gridColumns + 1) - rowBandStart(rank / gridColumns);
+		int columns = columnBandStart(rank % gridColumns + 1) - columnBandStart(rank % gridColumns);
+		if (!transport.receive(rank, tiles[rank].data) || tiles[rank].data.size() != 2 * (size_t)rows * columns)
+			return false;
+		tiles[rank].rows = rows;
+		tiles[rank].columns = columns;
+	}
+	tiles[0].data.swap(worker.tile.data);
+	tiles[0].rows = worker.tile.rows;
+	tiles[0].columns = worker.tile.columns;
+	for (int rank = 0; rank < transport.getSize(); rank++)
+		worker.storeTile(rank, tiles[rank], distancesMatrix, predecessorsMatrix);
+	return true;
+}
+
+bool DistributedFloydSolver::solveWithThreads()
+{
+	int size = gridRows * gridColumns;
+	LocalTransportHub hub(size);
+	std::vector<LocalTransport> transports;
+	for (int rank = 0; rank < size; rank++)
+		transports.push_back(LocalTransport(&hub, rank));
+
+	std::vector<char> results(size, 0);
+	std::vector<std::thread> workers;
+	for (int rank = 1; rank < size; rank++)
+	{
+		workers.push_back(std::thread([this, &transports, &results, rank]()
+		{
+			results[rank] = runWorker(transports[rank]);
+		}));
+	}
+	results[0] = runWorker(transports[0]);
+	for (unsigned int w = 0; w < workers.size(); w++)
+		workers[w].join();
+	return std::find(results.begin(), results.end(), 0) == results.end();
+}
+
+#ifndef _WIN32
+bool DistributedFloydSolver::solveWithProcesses()
+{
+	int size = gridRows * gridColumns;
+	std::vector<std::vector<int>> sockets;
+	if (!SocketTransport::createMesh(size, sockets))
+		return solveWithThreads();
+
+	//every worker but rank 0 is a copy of this process, so it has the initial matrices already.
+	//rank 0 is us, so the result is gathered right where it's needed
+	std::vector<pid_t> children;
+	for (int rank = 1; rank < size; rank++)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			bool isSucceeded;
+			{
+				SocketTransport transport(sockets, rank);
+				isSucceeded = runWorker(transport);
+			}
+			//leaving without destructors and atexit handlers, they belong to the parent
+			_exit(isSucceeded ? 0 : 1);
+		}
+		if (pid < 0)
+		{
+			//couldn't start everyone, those who are started would wait forever
+			for (unsigned int c = 0; c < children.size(); c++)
+			{
+				kill(children[c], SIGKILL);
+				waitpid(children[c], nullptr, 0);
+			}
+			SocketTransport::closeMesh(sockets);
+			return solveWithThreads();
+		}
+		children.push_back(pid);
+	}
+
+	bool isSucceeded;
+	{
+		SocketTransport transport(sockets, 0);
+		isSucceeded = runWorker(transport);
+	}
+	for (unsigned int c = 0; c < children.size(); c++)
+	{
+		int status = 0;
+		waitpid(children[c], &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			isSucceeded = false;
+	}
+	return isSucceeded;
+}
+#else
+bool DistributedFloydSolver::solveWithProcesses()
+{
+	return solveWithThreads();
+}
+#endif
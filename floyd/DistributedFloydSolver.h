@@ -0,0 +1,57 @@
+#pragma once
+#include "FloydSolver.h"
+#include "Transport.h"
+#include <vector>
+
+//blocked Floyd algorithm split between several workers by 2D grid of tiles.
+//worker (r, c) of gridRows x gridColumns grid owns rows band r and columns band c.
+//iterations are grouped into phases of up to blockSize vertices, each phase:
+//  - owner of the diagonal block closes it and sends it along its grid row and column;
+//  - owners of the phase rows (columns) update them with the block and send them down their grid column (row);
+//  - everyone updates the rest of its tile with received rows and columns.
+//the rows and columns of the next phase are updated first and sent right away,
+//so they travel while the rest of the tile is being updated.
+//workers talk only through Transport, so they can be threads or processes.
+//distances are exactly the same as Graph and DenseFloydSolver give. Predecessors may differ where there are
+//several shortest paths of the same length: tiles are relaxed through the whole phase with rows and columns
+//as they are after the phase, not after every single vertice, so equal paths may be met in another order.
+//paths built from them are still shortest ones. "Check distributed engine" in the menu runs it in several
+//process grids against DenseFloydSolver.
+class DistributedFloydSolver : public FloydSolver
+{
+public:
+	enum WorkersKind
+	{
+		Threads, //threads of this process talking through LocalTransport
+		Processes //forked processes talking through SocketTransport (threads on Windows)
+	};
+
+	DistributedFloydSolver(int** adjacencyMatrix, int verticesCount,
+		int gridRows = 2, int gridColumns = 2, int blockSize = 64, WorkersKind workersKind = Threads);
+
+	virtual void solve();
+
+	//runs the part of worker with transport's rank. Rank 0 puts the whole result to matrices,
+	//others send their tiles to it. Can be used with any other transport
+	//(every rank must use solver made from the same matrix and grid)
+	bool runWorker(Transport& transport);
+
+	//false if some worker has failed (e.g. a process has died) and matrices are incomplete
+	bool isCompleted;
+
+	int gridRows;
+	int gridColumns;
+	int blockSize;
+	WorkersKind workersKind;
+
+private:
+	//first row (column) of the band, band equal to count of bands gives the end
+	int rowBandStart(int band) const;
+	int columnBandStart(int band) const;
+
+	//borders of phases: every band border and every blockSize vertices
+	std::vector<int> phaseStarts;
+
+	bool solveWithThreads();
+	bool solveWithProcesses();
+};
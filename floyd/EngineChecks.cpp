@@ -0,0 +1,377 @@
+#include "EngineChecks.h"
+#include "DenseFloydSolver.h"
+#include "SparseFloydSolver.h"
+#include "SccFloydSolver.h"
+#include "DistributedFloydSolver.h"
+#include "ReorderedFloydSolver.h"
+#include "VertexOrdering.h"
+#include "BandedFloydSolver.h"
+#include "SourcesSolver.h"
+#include "LandmarkOracle.h"
+#include "MatrixWriter.h"
+#include "CompressedDistances.h"
+#include "BatchFloydSolver.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+using namespace std;
+
+namespace
+{
+	//runs solve() and returns how long it took in milliseconds
+	double measureSolve(FloydSolver& solver)
+	{
+		auto start = chrono::steady_clock::now();
+		solver.solve();
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	}
+
+	bool haveSameDistances(FloydSolver& first, FloydSolver& second)
+	{
+		for (int i = 0; i < first.verticesCount; i++)
+		{
+			for (int j = 0; j < first.verticesCount; j++)
+			{
+				if (first.distancesMatrix[i][j] != second.distancesMatrix[i][j])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	//counts pairs whose path by predecessors isn't made of existing edges or doesn't add up to the distance
+	int countWrongPaths(FloydSolver& solver)
+	{
+		int wrongCount = 0;
+		vector<int> path;
+		for (int i = 0; i < solver.verticesCount; i++)
+		{
+			for (int j = 0; j < solver.verticesCount; j++)
+			{
+				if (i == j || solver.distancesMatrix[i][j] == infinity)
+					continue;
+				solver.getPath(i, j, path);
+				long long length = 0;
+				for (unsigned int n = 0; n + 1 < path.size(); n++)
+				{
+					int weight = solver.adjacencyMatrix[path[n]][path[n + 1]];
+					length = weight == infinity || length == LLONG_MAX ? LLONG_MAX : length + weight;
+				}
+				if (path.empty() || length != solver.distancesMatrix[i][j])
+					wrongCount++;
+			}
+		}
+		return wrongCount;
+	}
+
+	//counters the system couldn't give are -1
+	string describeCount(long long count)
+	{
+		return count < 0 ? "n/a" : to_string(count);
+	}
+
+	//graph of 1 to maxVerticesCount vertices for the checks. Weights are small, so there are many paths of the same length.
+	//it's allocated the way floyd.cpp does, VertexOrdering::deleteMatrix gives it back
+	int** createRandomMatrix(mt19937& random, int maxVerticesCount, int& verticesCount)
+	{
+		verticesCount = 1 + random() % maxVerticesCount;
+		int density = 2 + random() % 10;
+		int** matrix = new int*[verticesCount];
+		for (int i = 0; i < verticesCount; i++)
+		{
+			matrix[i] = new int[verticesCount];
+			for (int j = 0; j < verticesCount; j++)
+				matrix[i][j] = i == j ? 0 : (random() % density == 0 ? 1 + random() % 5 : infinity);
+		}
+		return matrix;
+	}
+}
+
+void EngineChecks::compareEngines(int** adjacencyMatrix, int verticesCount)
+{
+	cout << "Solving graph of " << verticesCount << " vertices..." << endl;
+	//dense engine is the reference all others are checked against
+	DenseFloydSolver dense(adjacencyMatrix, verticesCount);
+	cout << "Dense: " << measureSolve(dense) << " ms" << endl;
+
+	SparseFloydSolver sparse(adjacencyMatrix, verticesCount);
+	cout << "Sparse: " << measureSolve(sparse) << " ms, "
+		<< sparse.relaxationsCount << " relaxations instead of " << (long long)verticesCount * verticesCount * verticesCount
+		<< (haveSameDistances(dense, sparse) ? ", same distances" : ", DIFFERENT distances") << endl;
+
+	SccFloydSolver scc(adjacencyMatrix, verticesCount);
+	cout << "Strongly connected components: " << measureSolve(scc) << " ms, "
+		<< scc.componentsCount << " components"
+		<< (haveSameDistances(dense, scc) ? ", same distances" : ", DIFFERENT distances") << endl;
+
+	//the same sparse engine on the matrix with vertices reordered for locality
+	ReorderedFloydSolver reordered(adjacencyMatrix, verticesCount, VertexOrdering::ReverseCuthillMcKee,
+		[](int** matrix, int count) -> FloydSolver* { return new SparseFloydSolver(matrix, count); });
+	cout << "Sparse in reverse Cuthill-McKee order: " << measureSolve(reordered) << " ms, "
+		<< "bandwidth " << VertexOrdering(adjacencyMatrix, verticesCount, VertexOrdering::Identity).getBandwidth(adjacencyMatrix)
+		<< " -> " << reordered.ordering->getBandwidth(adjacencyMatrix)
+		<< (haveSameDistances(dense, reordered) ? ", same distances" : ", DIFFERENT distances") << endl;
+
+	//exported files often list vertices in no particular order: the same graph shuffled,
+	//solved by sparse engine as it is and after reordering (fixed seed, so runs are comparable)
+	vector<int> shuffledOrder(verticesCount);
+	iota(shuffledOrder.begin(), shuffledOrder.end(), 0);
+	shuffle(shuffledOrder.begin(), shuffledOrder.end(), mt19937(2017));
+	int** shuffledMatrix = new int*[verticesCount];
+	for (int p = 0; p < verticesCount; p++)
+	{
+		shuffledMatrix[p] = new int[verticesCount];
+		for (int q = 0; q < verticesCount; q++)
+			shuffledMatrix[p][q] = adjacencyMatrix[shuffledOrder[p]][shuffledOrder[q]];
+	}
+	{
+		SparseFloydSolver shuffledSparse(shuffledMatrix, verticesCount);
+		double shuffledTime = measureSolve(shuffledSparse);
+		ReorderedFloydSolver shuffledReordered(shuffledMatrix, verticesCount, VertexOrdering::ReverseCuthillMcKee,
+			[](int** matrix, int count) -> FloydSolver* { return new SparseFloydSolver(matrix, count); });
+		double shuffledReorderedTime = measureSolve(shuffledReordered);
+		bool isShuffledSame = haveSameDistances(shuffledSparse, shuffledReordered);
+		for (int p = 0; p < verticesCount; p++)
+		{
+			for (int q = 0; q < verticesCount; q++)
+			{
+				if (shuffledSparse.distancesMatrix[p][q] != dense.distancesMatrix[shuffledOrder[p]][shuffledOrder[q]])
+					isShuffledSame = false;
+			}
+		}
+		cout << "Sparse on shuffled vertices: " << shuffledTime << " ms, bandwidth "
+			<< VertexOrdering(shuffledMatrix, verticesCount, VertexOrdering::Identity).getBandwidth(shuffledMatrix)
+			<< "; in reverse Cuthill-McKee order: " << shuffledReorderedTime << " ms, bandwidth "
+			<< shuffledReordered.ordering->getBandwidth(shuffledMatrix)
+			<< (isShuffledSame ? ", same distances" : ", DIFFERENT distances") << endl;
+	}
+	VertexOrdering::deleteMatrix(shuffledMatrix, verticesCount);
+
+	//rows split between threads: pages placed by the calling thread, then by their owners on huge pages
+	BandedFloydSolver bandedByOneThread(adjacencyMatrix, verticesCount, 0, MatrixAllocator::NormalPages, false);
+	BandedFloydSolver bandedByOwners(adjacencyMatrix, verticesCount);
+	BandedFloydSolver* bandedSolvers[] = { &bandedByOneThread, &bandedByOwners };
+	for (int b = 0; b < 2; b++)
+	{
+		BandedFloydSolver& banded = *bandedSolvers[b];
+		double bandedTime = measureSolve(banded);
+		cout << "Row bands " << (banded.isFirstTouchByOwner ? "placed by owners" : "placed by one thread")
+			<< (banded.actualPages == MatrixAllocator::NormalPages ? ", normal pages: " : ", huge pages: ") << bandedTime << " ms, "
+			<< "remote bytes " << describeCount(banded.remoteBytesCount)
+			<< ", TLB misses " << describeCount(banded.tlbMissesCount)
+			<< ", remote accesses " << describeCount(banded.remoteAccessesCount)
+			<< (haveSameDistances(dense, banded) ? ", same distances" : ", DIFFERENT distances") << endl;
+	}
+
+	//only rows of every 10th vertice
+	vector<int> sources;
+	for (int v = 0; v < verticesCount; v += 10)
+		sources.push_back(v);
+	SourcesSolver sourcesSolver(adjacencyMatrix, verticesCount, sources);
+	auto sourcesStart = chrono::steady_clock::now();
+	sourcesSolver.solve();
+	double sourcesTime = chrono::duration<double, milli>(chrono::steady_clock::now() - sourcesStart).count();
+	bool areSourcesSame = true;
+	for (unsigned int row = 0; row < sources.size(); row++)
+	{
+		for (int v = 0; v < verticesCount; v++)
+		{
+			if (sourcesSolver.getDistances(row)[v] != dense.distancesMatrix[sources[row]][v])
+				areSourcesSame = false;
+		}
+	}
+	const char* methodNames[] = { "Dijkstra", "Johnson", "Floyd" };
+	cout << sources.size() << " sources only (" << methodNames[sourcesSolver.method] << "): " << sourcesTime << " ms"
+		<< (areSourcesSame ? ", same distances" : ", DIFFERENT distances") << endl;
+
+	//no all pairs at all: landmarks, then separate queries of scattered pairs
+	LandmarkOracle oracle(adjacencyMatrix, verticesCount);
+	auto oracleStart = chrono::steady_clock::now();
+	if (oracle.prepare())
+	{
+		double prepareTime = chrono::duration<double, milli>(chrono::steady_clock::now() - oracleStart).count();
+		int queriesCount = 0;
+		long long settledCount = 0;
+		bool areQueriesSame = true;
+		oracleStart = chrono::steady_clock::now();
+		for (int s = 0; s < verticesCount && queriesCount < 1000; s++)
+		{
+			int t = (int)((s * 37LL + 11) % verticesCount);
+			if (s == t)
+				continue;
+			if (oracle.getDistance(s, t) != dense.distancesMatrix[s][t])
+				areQueriesSame = false;
+			settledCount += oracle.settledCount;
+			queriesCount++;
+		}
+		double queriesTime = chrono::duration<double, milli>(chrono::steady_clock::now() - oracleStart).count();
+		cout << oracle.landmarksCount << " landmarks: prepared in " << prepareTime << " ms, "
+			<< queriesCount << " queries in " << queriesTime << " ms, "
+			<< (queriesCount > 0 ? settledCount / queriesCount : 0) << " vertices settled per query"
+			<< (areQueriesSame ? ", same distances" : ", DIFFERENT distances") << endl;
+	}
+	else
+		cout << "Landmarks: not for negative weights" << endl;
+
+	//solved distances kept for lookups in several times less memory
+	CompressedDistances compressed(dense.distancesMatrix, verticesCount);
+	vector<int> compressedRow(verticesCount);
+	bool isCompressedSame = true;
+	for (int i = 0; i < verticesCount; i++)
+	{
+		compressed.getRow(i, compressedRow.data());
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (compressedRow[j] != dense.distancesMatrix[i][j] || compressed.get(i, j) != dense.distancesMatrix[i][j])
+				isCompressedSame = false;
+		}
+	}
+	//scattered lookups, so they aren't all in cache
+	const int lookupsCount = 1000000;
+	int reachableCount = 0;
+	auto lookupsStart = chrono::steady_clock::now();
+	for (int n = 0; n < lookupsCount && verticesCount > 0; n++)
+	{
+		if (compressed.get((int)((n * 7919LL) % verticesCount), (int)((n * 104729LL + 11) % verticesCount)) != infinity)
+			reachableCount++;
+	}
+	double lookupsTime = chrono::duration<double, milli>(chrono::steady_clock::now() - lookupsStart).count();
+	cout << "Compressed distances: " << compressed.getBytesCount() << " bytes instead of " << (long long)verticesCount * verticesCount * sizeof(int)
+		<< ", " << lookupsTime * 1000000 / lookupsCount << " ns per lookup (" << reachableCount << " of " << lookupsCount << " reachable)"
+		<< (isCompressedSame ? ", same distances" : ", DIFFERENT distances") << endl;
+
+	//separate processes where there are ones, threads otherwise
+	DistributedFloydSolver distributed(adjacencyMatrix, verticesCount, 2, 2, 64, DistributedFloydSolver::Processes);
+	double distributedTime = measureSolve(distributed);
+	if (distributed.isCompleted)
+		cout << "Distributed (" << distributed.gridRows << "x" << distributed.gridColumns << " workers): " << distributedTime << " ms"
+			<< (haveSameDistances(dense, distributed) ? ", same distances" : ", DIFFERENT distances") << endl;
+	else
+		cout << "Distributed: some worker has failed" << endl;
+
+}
+
+void EngineChecks::saveSolution(int** adjacencyMatrix, int verticesCount)
+{
+	cout << "Solving graph of " << verticesCount << " vertices..." << endl;
+	DenseFloydSolver dense(adjacencyMatrix, verticesCount);
+	cout << "Solved in " << measureSolve(dense) << " ms" << endl;
+
+	//the same text as input.txt, so results can be loaded back; gzip too if it's built with zlib
+	const char* fileNames[2][2] = { { "distances.txt", "predecessors.txt" }, { "distances.txt.gz", "predecessors.txt.gz" } };
+	int** matrices[] = { dense.distancesMatrix, dense.predecessorsMatrix };
+	for (int compressed = 0; compressed < (MatrixWriter::canCompress() ? 2 : 1); compressed++)
+	{
+		for (int m = 0; m < 2; m++)
+		{
+			MatrixWriter writer(0, compressed == 1);
+			auto writeStart = chrono::steady_clock::now();
+			bool isWritten = writer.write(fileNames[compressed][m], matrices[m], verticesCount);
+			double writeTime = chrono::duration<double, milli>(chrono::steady_clock::now() - writeStart).count();
+			if (isWritten)
+				cout << fileNames[compressed][m] << ": " << writer.bytesCount << " bytes in " << writeTime << " ms" << endl;
+			else
+				cout << fileNames[compressed][m] << " couldn't be written" << endl;
+		}
+	}
+}
+
+void EngineChecks::checkDistributed()
+{
+	const int gridsCount = 5;
+	const int grids[gridsCount][2] = { { 1, 2 }, { 2, 1 }, { 2, 2 }, { 3, 2 }, { 3, 3 } };
+	const int graphsCount = 30;
+	int failedCounts[gridsCount] = {};
+	long long differentPredecessorsCounts[gridsCount] = {};
+	mt19937 random(2017);
+	cout << "Solving " << graphsCount << " random graphs in every grid of worker processes..." << endl;
+	for (int g = 0; g < graphsCount; g++)
+	{
+		int verticesCount;
+		int** matrix = createRandomMatrix(random, 150, verticesCount);
+		DenseFloydSolver dense(matrix, verticesCount);
+		dense.solve();
+		for (int grid = 0; grid < gridsCount; grid++)
+		{
+			int blockSize = 1 + random() % 32;
+			DistributedFloydSolver distributed(matrix, verticesCount, grids[grid][0], grids[grid][1], blockSize, DistributedFloydSolver::Processes);
+			distributed.solve();
+			if (!distributed.isCompleted || !haveSameDistances(dense, distributed) || countWrongPaths(distributed) != 0)
+			{
+				failedCounts[grid]++;
+				continue;
+			}
+			for (int i = 0; i < verticesCount; i++)
+			{
+				for (int j = 0; j < verticesCount; j++)
+				{
+					if (distributed.predecessorsMatrix[i][j] != dense.predecessorsMatrix[i][j])
+						differentPredecessorsCounts[grid]++;
+				}
+			}
+		}
+		VertexOrdering::deleteMatrix(matrix, verticesCount);
+	}
+	for (int grid = 0; grid < gridsCount; grid++)
+	{
+		cout << grids[grid][0] << "x" << grids[grid][1] << ": "
+			<< (failedCounts[grid] == 0 ? "all same distances and shortest paths" : to_string(failedCounts[grid]) + " graphs FAILED")
+			<< ", " << differentPredecessorsCounts[grid] << " predecessors of equal paths differ from dense" << endl;
+	}
+}
+
+void EngineChecks::checkBatch()
+{
+	const int graphsCount = 2000;
+	mt19937 random(2017);
+	cout << "Solving " << graphsCount << " small random graphs in one batch and one by one..." << endl;
+	//matrices have to live until the batch is solved
+	vector<int**> matrices(graphsCount);
+	vector<int> verticesCounts(graphsCount);
+	BatchFloydSolver batch;
+	for (int g = 0; g < graphsCount; g++)
+	{
+		matrices[g] = createRandomMatrix(random, 64, verticesCounts[g]);
+		batch.addGraph(matrices[g], verticesCounts[g]);
+	}
+	auto batchStart = chrono::steady_clock::now();
+	batch.solve();
+	double batchTime = chrono::duration<double, milli>(chrono::steady_clock::now() - batchStart).count();
+
+	double denseTime = 0;
+	int failedCount = 0;
+	long long differentPredecessorsCount = 0;
+	for (int g = 0; g < graphsCount; g++)
+	{
+		int verticesCount = verticesCounts[g];
+		DenseFloydSolver dense(matrices[g], verticesCount);
+		denseTime += measureSolve(dense);
+		const int* distances = batch.getDistances(g);
+		const int* predecessors = batch.getPredecessors(g);
+		bool isFailed = false;
+		for (int i = 0; i < verticesCount; i++)
+		{
+			for (int j = 0; j < verticesCount; j++)
+			{
+				if (distances[i * verticesCount + j] != dense.distancesMatrix[i][j])
+					isFailed = true;
+				else if (predecessors[i * verticesCount + j] != dense.predecessorsMatrix[i][j])
+					differentPredecessorsCount++;
+			}
+		}
+		if (isFailed)
+			failedCount++;
+		VertexOrdering::deleteMatrix(matrices[g], verticesCount);
+	}
+	cout << "Batch: " << batchTime << " ms, dense one by one: " << denseTime << " ms" << endl
+		<< (failedCount == 0 ? "all same distances" : to_string(failedCount) + " graphs FAILED")
+		<< ", " << differentPredecessorsCount << " predecessors differ from dense" << endl;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+//benchmarks and self-checks of the engines the menu runs without visualization.
+//they only print to console, waiting for a key is up to the caller
+class EngineChecks
+{
+public:
+	//solves the graph with every engine, prints their timings and compares results with dense engine
+	static void compareEngines(int** adjacencyMatrix, int verticesCount);
+	//solves the graph and writes distances and predecessors to text files next to the executable
+	static void saveSolution(int** adjacencyMatrix, int verticesCount);
+	//runs distributed engine in several process grids on random graphs and compares it with dense one.
+	//graphs come from a fixed seed, so every run checks the same ones
+	static void checkDistributed();
+	//solves lots of small random graphs in one batch and compares them with dense engine solving them one by one
+	static void checkBatch();
+};
@@ -0,0 +1,56 @@
+#include "FloydSolver.h"
+#include "MatrixAllocator.h"
+#include <limits.h>
+#include <algorithm>
+
+#define infinity INT_MAX
+
+FloydSolver::FloydSolver(int** adjacencyMatrix, int verticesCount)
+{
+	this->verticesCount = verticesCount;
+	this->adjacencyMatrix = adjacencyMatrix;
+
+	this->distancesMatrix = MatrixAllocator::allocate(verticesCount);
+	this->predecessorsMatrix = MatrixAllocator::allocate(verticesCount);
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			//initial distances are the adjacency matrix,
+			//and every existing edge is a path with i as predecessor
+			distancesMatrix[i][j] = adjacencyMatrix[i][j];
+			predecessorsMatrix[i][j] = adjacencyMatrix[i][j] != infinity ? i : -1;
+		}
+	}
+}
+
+FloydSolver::~FloydSolver()
+{
+	MatrixAllocator::release(this->distancesMatrix);
+	MatrixAllocator::release(this->predecessorsMatrix);
+}
+
+void FloydSolver::getPath(int start, int finish, std::vector<int> &path)
+{
+	buildPath(predecessorsMatrix[start], start, finish, verticesCount, path);
+}
+
+void buildPath(const int* predecessorsRow, int start, int finish, int verticesCount, std::vector<int>& path)
+{
+	path.clear();
+	//walking from finish back to start by predecessors
+	int current = finish;
+	while (current != start)
+	{
+		//no path (the length check protects from going round if something's broken)
+		if (current == -1 || (int)path.size() >= verticesCount)
+		{
+			path.clear();
+			return;
+		}
+		path.push_back(current);
+		current = predecessorsRow[current];
+	}
+	path.push_back(start);
+	std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+
+//base of engines solving the whole all-pairs problem at once, without stepping
+//(Graph is the one made for step-by-step visualization).
+//matrices have the same meaning as distancesMatrixAfterIteration and
+//predecessorsMatrixAfterIteration of Graph once solve() is done.
+class FloydSolver
+{
+public:
+	//allocates matrices and fills them up with initial values like Graph does
+	FloydSolver(int** adjacencyMatrix, int verticesCount);
+	virtual ~FloydSolver();
+
+	//original adjacency matrix of graph (not owned)
+	int** adjacencyMatrix;
+	int verticesCount;
+
+	//matrices are made by MatrixAllocator, engines may replace them with their own made by it too.
+	//minimum distance from i vertice to j vertice
+	int** distancesMatrix;
+	//predecessor of j on the shortest path from i to j, -1 if there's no path
+	int** predecessorsMatrix;
+
+	//runs the algorithm to the end
+	virtual void solve() = 0;
+
+	//constructs path between start and finish vertices from predecessors matrix.
+	//the path is empty if there's none
+	void getPath(int start, int finish, std::vector<int> &path);
+};
+
+//constructs path between start and finish vertices from the row of start in a predecessors matrix
+//(predecessor of every vertice on the shortest path from start, -1 if there's no path).
+//the path is empty if there's none. Every engine keeping predecessors this way builds its paths with it
+void buildPath(const int* predecessorsRow, int start, int finish, int verticesCount, std::vector<int>& path);
@@ -0,0 +1,126 @@
+#include "FloydSolverThread.h"
+#include <chrono>
+
+//how long solver sleeps when renderer hasn't taken anything from the full queue yet
+#define FULL_QUEUE_BACKOFF_MS 1
+
+FloydSolverThread::FloydSolverThread(Graph* graph, size_t queueCapacity)
+	: events(queueCapacity)
+{
+	this->graph = graph;
+	this->recorder = nullptr;
+	stopRequested = false;
+	skipRequested = false;
+	finished = false;
+}
+
+FloydSolverThread::~FloydSolverThread()
+{
+	//we can't leave thread running with the graph which is going to be destroyed
+	stop();
+}
+
+void FloydSolverThread::setRecorder(FloydTraceRecorder* recorder, const std::string& traceFileName)
+{
+	this->recorder = recorder;
+	this->traceFileName = traceFileName;
+}
+
+void FloydSolverThread::start()
+{
+	if (thread.joinable())
+		return;
+	stopRequested = false;
+	thread = std::thread(&FloydSolverThread::run, this);
+}
+
+void FloydSolverThread::stop()
+{
+	stopRequested = true;
+	if (thread.joinable())
+		thread.join();
+}
+
+void FloydSolverThread::skipToEnd()
+{
+	skipRequested = true;
+}
+
+bool FloydSolverThread::pollEvent(StepEvent& event)
+{
+	return events.tryPop(event);
+}
+
+bool FloydSolverThread::isFinished() const
+{
+	return finished;
+}
+
+void FloydSolverThread::run()
+{
+	int lastK = graph->k;
+	while (!stopRequested)
+	{
+		//nobody is going to look at cells, so no events for them and no paths.
+		//iterations are still recorded, the trace stays complete
+		if (skipRequested)
+		{
+			while (!stopRequested && graph->skipIteration())
+			{
+				if (recorder != nullptr)
+					recorder->recordIteration(graph, graph->k);
+			}
+			lastK = graph->k;
+		}
+		StepEvent event;
+		event.result = graph->floydStep();
+		//if floydStep has just made an iteration, its before and after matrices
+		//are exactly what recorder needs. One step can make the last iteration and reach the end
+		//at once (a single vertex), the matrices still hold that iteration then
+		if (recorder != nullptr)
+		{
+			int lastIteration = graph->k < graph->verticesCount ? graph->k : graph->verticesCount - 1;
+			for (int k = lastK + 1; k <= lastIteration; k++)
+				recorder->recordIteration(graph, k);
+		}
+		lastK = graph->k;
+		event.k = graph->k;
+		event.i = graph->i;
+		event.j = graph->j;
+		if (event.result != Graph::FloydStepResult::EndOfAlgorithm)
+		{
+			event.oldDistance = graph->distancesMatrixBeforeIteration[event.i][event.j];
+			event.newDistance = graph->distancesMatrixAfterIteration[event.i][event.j];
+		}
+		//constructing the path right here, because on the next step predecessors may change
+		switch (event.result)
+		{
+		case Graph::FloydStepResult::BetterPathFound:
+			graph->getPath(event.i, event.j, event.path, true);
+			break;
+		case Graph::FloydStepResult::BetterPathApplied:
+		case Graph::FloydStepResult::PathFoundAndApplied:
+			graph->getPath(event.i, event.j, event.path);
+			break;
+		default:
+			break;
+		}
+
+		bool isLast = event.result == Graph::FloydStepResult::EndOfAlgorithm;
+		//if renderer is behind we'll wait for it, it consumes events at its own pace
+		while (!events.tryPush(std::move(event)))
+		{
+			if (stopRequested)
+				return;
+			std::this_thread::sleep_for(std::chrono::milliseconds(FULL_QUEUE_BACKOFF_MS));
+		}
+		if (isLast)
+		{
+			//renderer already has the end to show, writing the file doesn't hold it
+			if (recorder != nullptr)
+				recorder->saveIfComplete(traceFileName);
+			finished = true;
+			return;
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Graph.h"
+#include "StepEventSource.h"
+#include "FloydTrace.h"
+#include "SpscQueue.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+
+//runs floydStep of the given graph on its own thread and publishes
+//the results as StepEvents through a lock-free single-producer/single-consumer queue
+class FloydSolverThread : public StepEventSource
+{
+public:
+	//the graph must not be touched by anybody else while the thread is running
+	FloydSolverThread(Graph* graph, size_t queueCapacity = 1024);
+	virtual ~FloydSolverThread();
+
+	//if set before start, every iteration made by solver is written to the recorder,
+	//and when the algorithm ends the trace is saved to the file right here, not on the renderer's thread
+	void setRecorder(FloydTraceRecorder* recorder, const std::string& traceFileName);
+
+	void start();
+	//asks the solver to stop and waits for it
+	void stop();
+	//asks the solver to make the rest of iterations at once and publish only EndOfAlgorithm
+	//(events already in the queue stay there)
+	void skipToEnd();
+
+	//pops the next event if there's one. Should be called from one thread only
+	virtual bool pollEvent(StepEvent& event);
+
+	//true if the solver has published EndOfAlgorithm and saved the trace (the event itself may still be in the queue)
+	bool isFinished() const;
+
+private:
+	//solver loop
+	void run();
+
+	Graph* graph;
+	FloydTraceRecorder* recorder;
+	std::string traceFileName;
+	SpscQueue<StepEvent> events;
+	std::thread thread;
+	std::atomic<bool> stopRequested;
+	std::atomic<bool> skipRequested;
+	std::atomic<bool> finished;
+};
@@ -0,0 +1,279 @@
+#include "FloydTrace.h"
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+#define TRACE_MAGIC "FWTR"
+#define TRACE_VERSION 1
+
+//little helpers for LEB128 varints and zigzag encoding of signed values
+static void writeVarint(std::vector<unsigned char>& out, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+//reads varint at position and moves position after it.
+//returns false if data ends in the middle of it
+static bool readVarint(const std::vector<unsigned char>& in, size_t& position, unsigned long long& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (position >= in.size())
+			return false;
+		unsigned char byte = in[position++];
+		value |= (unsigned long long)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+//same but for data we've already validated on loading
+static unsigned long long readVarint(const std::vector<unsigned char>& in, size_t& position)
+{
+	unsigned long long value;
+	readVarint(in, position, value);
+	return value;
+}
+
+static unsigned long long zigzag(long long value)
+{
+	return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static long long unzigzag(unsigned long long value)
+{
+	return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+FloydTrace::FloydTrace()
+{
+	verticesCount = 0;
+	keyframeInterval = 1;
+}
+
+int FloydTrace::getVerticesCount() const
+{
+	return verticesCount;
+}
+
+bool FloydTrace::isComplete() const
+{
+	return verticesCount > 0 && (int)iterationOffsets.size() == verticesCount;
+}
+
+bool FloydTrace::saveToFile(const std::string& fileName) const
+{
+	std::ofstream output(fileName, std::ios::binary);
+	if (!output.is_open())
+		return false;
+	std::vector<unsigned char> header(TRACE_MAGIC, TRACE_MAGIC + 4);
+	writeVarint(header, TRACE_VERSION);
+	writeVarint(header, verticesCount);
+	writeVarint(header, keyframeInterval);
+	output.write((const char*)header.data(), header.size());
+	output.write((const char*)data.data(), data.size());
+	return output.good();
+}
+
+bool FloydTrace::loadFromFile(const std::string& fileName)
+{
+	std::ifstream input(fileName, std::ios::binary);
+	if (!input.is_open())
+		return false;
+	std::vector<unsigned char> file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	//checking header
+	if (file.size() < 4 || !std::equal(file.begin(), file.begin() + 4, TRACE_MAGIC))
+		return false;
+	size_t position = 4;
+	unsigned long long version, vertices, interval;
+	if (!readVarint(file, position, version) || version != TRACE_VERSION
+		|| !readVarint(file, position, vertices) || vertices == 0 || vertices > INT_MAX
+		|| !readVarint(file, position, interval) || interval == 0 || interval > INT_MAX)
+		return false;
+
+	std::vector<unsigned char> body(file.begin() + position, file.end());
+	std::vector<size_t> keyframes;
+	std::vector<size_t> iterations;
+
+	//walking through the whole trace once to find where everything starts
+	//(and to make sure it's not broken, so we won't have to check anything later)
+	unsigned long long cellsCount = vertices * vertices;
+	unsigned long long value;
+	position = 0;
+	for (unsigned long long k = 0; k < vertices; k++)
+	{
+		if (k % interval == 0)
+		{
+			keyframes.push_back(position);
+			for (unsigned long long n = 0; n < cellsCount * 2; n++)
+			{
+				//odd ones are predecessors + 1, replayer follows them so they must be vertices (or 0 for none)
+				if (!readVarint(body, position, value) || (n % 2 == 1 && value > vertices))
+					return false;
+			}
+		}
+		iterations.push_back(position);
+		unsigned long long changedCount;
+		if (!readVarint(body, position, changedCount) || changedCount > cellsCount)
+			return false;
+		unsigned long long cell = 0;
+		for (unsigned long long n = 0; n < changedCount; n++)
+		{
+			unsigned long long gap;
+			if (!readVarint(body, position, gap))
+				return false;
+			cell += gap + (n == 0 ? 0 : 1);
+			if (cell >= cellsCount || !readVarint(body, position, value) || !readVarint(body, position, value) || value >= vertices)
+				return false;
+		}
+	}
+
+	verticesCount = (int)vertices;
+	keyframeInterval = (int)interval;
+	data.swap(body);
+	keyframeOffsets.swap(keyframes);
+	iterationOffsets.swap(iterations);
+	return true;
+}
+
+void FloydTrace::readKeyframe(size_t offset, int** distances, int** predecessors) const
+{
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			unsigned long long code = readVarint(data, offset);
+			distances[i][j] = code == 0 ? infinity : (int)unzigzag(code - 1);
+			predecessors[i][j] = (int)readVarint(data, offset) - 1;
+		}
+	}
+}
+
+void FloydTrace::applyIteration(int k, int** distances, int** predecessors) const
+{
+	size_t offset = iterationOffsets[k];
+	unsigned long long changedCount = readVarint(data, offset);
+	unsigned long long cell = 0;
+	for (unsigned long long n = 0; n < changedCount; n++)
+	{
+		cell += readVarint(data, offset) + (n == 0 ? 0 : 1);
+		int i = (int)(cell / verticesCount);
+		int j = (int)(cell % verticesCount);
+		distances[i][j] = (int)unzigzag(readVarint(data, offset));
+		predecessors[i][j] = (int)readVarint(data, offset);
+	}
+}
+
+void FloydTrace::restoreState(int iterations, int** distances, int** predecessors) const
+{
+	//the nearest keyframe not after the requested state
+	int keyframe = iterations / keyframeInterval;
+	if (keyframe >= (int)keyframeOffsets.size())
+		keyframe = (int)keyframeOffsets.size() - 1;
+	readKeyframe(keyframeOffsets[keyframe], distances, predecessors);
+	//and iterations made since it
+	for (int k = keyframe * keyframeInterval; k < iterations; k++)
+	{
+		applyIteration(k, distances, predecessors);
+	}
+}
+
+int** FloydTrace::createAdjacencyMatrix() const
+{
+	//initial distances are the adjacency matrix itself, predecessors we don't need here
+	int** adjacencyMatrix = new int*[verticesCount];
+	int** predecessors = new int*[verticesCount];
+	for (int i = 0; i < verticesCount; i++)
+	{
+		adjacencyMatrix[i] = new int[verticesCount];
+		predecessors[i] = new int[verticesCount];
+	}
+	readKeyframe(keyframeOffsets[0], adjacencyMatrix, predecessors);
+	for (int i = 0; i < verticesCount; i++)
+	{
+		delete[] predecessors[i];
+	}
+	delete[] predecessors;
+	return adjacencyMatrix;
+}
+
+FloydTraceRecorder::FloydTraceRecorder(FloydTrace* trace, int verticesCount, int keyframeInterval)
+{
+	this->trace = trace;
+	trace->verticesCount = verticesCount;
+	if (keyframeInterval <= 0)
+	{
+		//a keyframe is V^2 cells, so there can't be V of them for big graphs
+		keyframeInterval = (verticesCount + TRACE_MAX_KEYFRAMES - 1) / TRACE_MAX_KEYFRAMES;
+		if (keyframeInterval < TRACE_MIN_KEYFRAME_INTERVAL)
+			keyframeInterval = TRACE_MIN_KEYFRAME_INTERVAL;
+	}
+	trace->keyframeInterval = keyframeInterval;
+	trace->data.clear();
+	trace->keyframeOffsets.clear();
+	trace->iterationOffsets.clear();
+}
+
+void FloydTraceRecorder::recordIteration(Graph* graph, int k)
+{
+	int verticesCount = trace->verticesCount;
+	//iterations can only be recorded one after another
+	if (k != (int)trace->iterationOffsets.size() || k >= verticesCount)
+		return;
+
+	std::vector<unsigned char>& data = trace->data;
+	//the state before iteration is a keyframe every keyframeInterval iterations
+	if (k % trace->keyframeInterval == 0)
+	{
+		trace->keyframeOffsets.push_back(data.size());
+		for (int i = 0; i < verticesCount; i++)
+		{
+			for (int j = 0; j < verticesCount; j++)
+			{
+				int distance = graph->distancesMatrixBeforeIteration[i][j];
+				writeVarint(data, distance == infinity ? 0 : zigzag(distance) + 1);
+				writeVarint(data, (unsigned long long)(graph->predecessorsMatrixBeforeIteration[i][j] + 1));
+			}
+		}
+	}
+
+	//and then cells changed by iteration.
+	//distances only decrease during the algorithm so new ones are never infinity
+	std::vector<unsigned char> cells;
+	unsigned long long changedCount = 0;
+	long long previousCell = -1;
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (graph->distancesMatrixAfterIteration[i][j] == graph->distancesMatrixBeforeIteration[i][j]
+				&& graph->predecessorsMatrixAfterIteration[i][j] == graph->predecessorsMatrixBeforeIteration[i][j])
+				continue;
+			long long cell = (long long)i * verticesCount + j;
+			writeVarint(cells, previousCell < 0 ? cell : cell - previousCell - 1);
+			writeVarint(cells, zigzag(graph->distancesMatrixAfterIteration[i][j]));
+			writeVarint(cells, graph->predecessorsMatrixAfterIteration[i][j]);
+			previousCell = cell;
+			changedCount++;
+		}
+	}
+	trace->iterationOffsets.push_back(data.size());
+	writeVarint(data, changedCount);
+	data.insert(data.end(), cells.begin(), cells.end());
+}
+
+bool FloydTraceRecorder::saveIfComplete(const std::string& fileName) const
+{
+	return trace->isComplete() && trace->saveToFile(fileName);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "Graph.h"
+#include <string>
+#include <vector>
+
+//the file visualizer saves its trace to and the menu replays it from
+#define DEFAULT_TRACE_FILE_NAME "trace.fwt"
+//keyframes are every 8 iterations for small graphs, and rarer for big ones so there are no more than this
+#define TRACE_MIN_KEYFRAME_INTERVAL 8
+#define TRACE_MAX_KEYFRAMES 16
+//live runs of bigger graphs aren't recorded, the trace grows as V^3 and would take hundreds of megabytes
+#define TRACE_MAX_RECORDED_VERTICES 500
+
+//compact binary record of a complete run of Floyd algorithm.
+//it consists of what every iteration changed in distances and predecessors matrices
+//plus full copies of the matrices (keyframes) every few iterations,
+//so any state can be restored without running the algorithm again.
+//there are at most TRACE_MAX_KEYFRAMES keyframes, so they take O(V^2) and not O(V^3) for big graphs
+//
+//layout (all numbers are unsigned LEB128 varints):
+//  "FWTR", version, verticesCount, keyframeInterval,
+//  then for every iteration k: [keyframe of state before k if k % keyframeInterval == 0], delta of k
+//keyframe: for every cell distance code (0 for infinity, zigzag(distance)+1 otherwise) and predecessor+1
+//delta: count of changed cells, then for every cell gap from previous changed cell index,
+//zigzag(new distance) and new predecessor
+class FloydTrace
+{
+public:
+	FloydTrace();
+
+	//both return false if something went wrong with file (or it's not a trace)
+	bool loadFromFile(const std::string& fileName);
+	bool saveToFile(const std::string& fileName) const;
+
+	int getVerticesCount() const;
+	//true if all iterations are recorded
+	bool isComplete() const;
+
+	//fills matrices with the state after given count of iterations (0 is initial state).
+	//it starts from the nearest keyframe so it never replays more than keyframeInterval iterations
+	void restoreState(int iterations, int** distances, int** predecessors) const;
+	//applies changes made by iteration k to matrices holding the state before it
+	void applyIteration(int k, int** distances, int** predecessors) const;
+
+	//allocates adjacency matrix (as floyd.cpp does) from the initial state
+	int** createAdjacencyMatrix() const;
+
+private:
+	friend class FloydTraceRecorder;
+
+	int verticesCount;
+	int keyframeInterval;
+	//encoded trace (without header)
+	std::vector<unsigned char> data;
+	//where each keyframe and each iteration delta start in data
+	std::vector<size_t> keyframeOffsets;
+	std::vector<size_t> iterationOffsets;
+
+	void readKeyframe(size_t offset, int** distances, int** predecessors) const;
+};
+
+//writes iterations of a graph to a trace while floyd algorithm is running
+class FloydTraceRecorder
+{
+public:
+	//keyframe interval is picked by verticesCount if it's 0
+	FloydTraceRecorder(FloydTrace* trace, int verticesCount, int keyframeInterval = 0);
+
+	//should be called right after graph has performed iteration k,
+	//when its before and after matrices hold the state before and after it.
+	//it's graph->k, except the last iteration, graph->k is verticesCount already then
+	void recordIteration(Graph* graph, int k);
+	//saves the trace to file if all iterations are recorded, false if they're not or file can't be written
+	bool saveIfComplete(const std::string& fileName) const;
+
+private:
+	FloydTrace* trace;
+};
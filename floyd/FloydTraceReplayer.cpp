@@ -0,0 +1,252 @@
+#include "FloydTraceReplayer.h"
+#include "FloydSolver.h"
+#include <algorithm>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+FloydTraceReplayer::FloydTraceReplayer(const FloydTrace* trace)
+{
+	this->trace = trace;
+	this->verticesCount = trace->getVerticesCount();
+	this->distancesBefore = new int*[verticesCount];
+	this->distancesAfter = new int*[verticesCount];
+	this->predecessorsBefore = new int*[verticesCount];
+	this->predecessorsAfter = new int*[verticesCount];
+	for (int i = 0; i < verticesCount; i++)
+	{
+		this->distancesBefore[i] = new int[verticesCount];
+		this->distancesAfter[i] = new int[verticesCount];
+		this->predecessorsBefore[i] = new int[verticesCount];
+		this->predecessorsAfter[i] = new int[verticesCount];
+	}
+	//we're before the first event, nothing is loaded yet
+	k = -1;
+	i = 0;
+	j = verticesCount;
+	phase = 0;
+	loadedIteration = -1;
+}
+
+FloydTraceReplayer::~FloydTraceReplayer()
+{
+	for (int i = 0; i < verticesCount; i++)
+	{
+		delete[] this->distancesBefore[i];
+		delete[] this->distancesAfter[i];
+		delete[] this->predecessorsBefore[i];
+		delete[] this->predecessorsAfter[i];
+	}
+	delete[] this->distancesBefore;
+	delete[] this->distancesAfter;
+	delete[] this->predecessorsBefore;
+	delete[] this->predecessorsAfter;
+}
+
+int FloydTraceReplayer::getVerticesCount() const
+{
+	return verticesCount;
+}
+
+bool FloydTraceReplayer::pollEvent(StepEvent& event)
+{
+	//end of algorithm is reported only once, like the solver does
+	if (k == verticesCount)
+		return false;
+	if (k == -1)
+	{
+		k = 0;
+		i = 0;
+		j = verticesCount;
+		loadIteration(0);
+		nextCell();
+		phase = 0;
+	}
+	//better path is shown twice - bad one first, then good one
+	else if (phase == 0 && eventsCount(i, j) == 2)
+	{
+		phase = 1;
+	}
+	else
+	{
+		nextCell();
+		phase = 0;
+	}
+	makeEvent(event);
+	return true;
+}
+
+bool FloydTraceReplayer::stepBack(StepEvent& event)
+{
+	if (k == -1)
+		return false;
+	if (phase == 1)
+	{
+		phase = 0;
+		makeEvent(event);
+		return true;
+	}
+	//remembering where we are in case we're already at the first event
+	int oldK = k, oldI = i, oldJ = j;
+	if (k == verticesCount)
+	{
+		k = verticesCount - 1;
+		i = verticesCount - 1;
+		j = -1;
+		loadIteration(k);
+	}
+	previousCell();
+	if (k < 0)
+	{
+		k = oldK;
+		i = oldI;
+		j = oldJ;
+		return false;
+	}
+	phase = eventsCount(i, j) - 1;
+	makeEvent(event);
+	return true;
+}
+
+bool FloydTraceReplayer::seek(int k, int i, int j, StepEvent& event)
+{
+	if (k < 0)
+		k = 0;
+	this->phase = 0;
+	if (k >= verticesCount)
+	{
+		this->k = verticesCount;
+		makeEvent(event);
+		return true;
+	}
+	if (i < 0 || i >= verticesCount || j < 0 || j >= verticesCount)
+	{
+		i = 0;
+		j = verticesCount - 1;
+	}
+	this->k = k;
+	this->i = i;
+	this->j = j;
+	loadIteration(k);
+	//there are no events for path from vertice to itself, taking the next one
+	if (i == j)
+		nextCell();
+	makeEvent(event);
+	return true;
+}
+
+void FloydTraceReplayer::loadIteration(int k)
+{
+	if (k == loadedIteration)
+		return;
+	if (loadedIteration >= 0 && k == loadedIteration + 1)
+	{
+		//the state after previous iteration is the state before this one
+		copyMatrix(distancesAfter, distancesBefore, verticesCount);
+		copyMatrix(predecessorsAfter, predecessorsBefore, verticesCount);
+	}
+	else
+	{
+		//jumping somewhere - starting from the nearest keyframe
+		trace->restoreState(k, distancesBefore, predecessorsBefore);
+		copyMatrix(distancesBefore, distancesAfter, verticesCount);
+		copyMatrix(predecessorsBefore, predecessorsAfter, verticesCount);
+	}
+	trace->applyIteration(k, distancesAfter, predecessorsAfter);
+	loadedIteration = k;
+}
+
+int FloydTraceReplayer::eventsCount(int i, int j) const
+{
+	if (distancesAfter[i][j] < distancesBefore[i][j] && distancesBefore[i][j] != infinity)
+		return 2;
+	return 1;
+}
+
+void FloydTraceReplayer::nextCell()
+{
+	//same order as in Graph::updateIndices: i goes up, j goes down, i == j is skipped
+	do
+	{
+		j--;
+		if (j < 0)
+		{
+			j = verticesCount - 1;
+			i++;
+			if (i == verticesCount)
+			{
+				i = 0;
+				k++;
+				if (k == verticesCount)
+					return;
+				loadIteration(k);
+			}
+		}
+	} while (i == j);
+}
+
+void FloydTraceReplayer::previousCell()
+{
+	do
+	{
+		j++;
+		if (j == verticesCount)
+		{
+			j = 0;
+			i--;
+			if (i < 0)
+			{
+				i = verticesCount - 1;
+				k--;
+				if (k < 0)
+					return;
+				loadIteration(k);
+			}
+		}
+	} while (i == j);
+}
+
+void FloydTraceReplayer::makeEvent(StepEvent& event) const
+{
+	event.k = k;
+	event.i = i;
+	event.j = j;
+	event.path.clear();
+	if (k == verticesCount)
+	{
+		event.result = Graph::FloydStepResult::EndOfAlgorithm;
+		return;
+	}
+	event.oldDistance = distancesBefore[i][j];
+	event.newDistance = distancesAfter[i][j];
+	if (event.newDistance < event.oldDistance)
+	{
+		if (event.oldDistance == infinity)
+		{
+			event.result = Graph::FloydStepResult::PathFoundAndApplied;
+			buildPath(predecessorsAfter[i], i, j, verticesCount, event.path);
+		}
+		else if (phase == 0)
+		{
+			event.result = Graph::FloydStepResult::BetterPathFound;
+			buildPath(predecessorsBefore[i], i, j, verticesCount, event.path);
+		}
+		else
+		{
+			event.result = Graph::FloydStepResult::BetterPathApplied;
+			buildPath(predecessorsAfter[i], i, j, verticesCount, event.path);
+		}
+	}
+	else
+	{
+		event.result = Graph::FloydStepResult::NoPathFound;
+	}
+}
+
+void FloydTraceReplayer::copyMatrix(int** from, int** to, int size)
+{
+	for (int i = 0; i < size; i++)
+	{
+		std::copy(from[i], from[i] + size, to[i]);
+	}
+}
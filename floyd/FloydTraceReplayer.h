@@ -0,0 +1,54 @@
+#pragma once
+#include "FloydTrace.h"
+#include "StepEventSource.h"
+
+//plays a recorded trace back as the same step events floydStep would produce,
+//but in both directions and from any point, without running the algorithm again.
+//only two states of the matrices (before and after current iteration) are kept in memory.
+class FloydTraceReplayer : public StepEventSource
+{
+public:
+	//the trace must be complete and outlive the replayer
+	FloydTraceReplayer(const FloydTrace* trace);
+	virtual ~FloydTraceReplayer();
+
+	//moves one event forward and returns it
+	virtual bool pollEvent(StepEvent& event);
+	//moves one event backward and returns it. Returns false at the first event
+	bool stepBack(StepEvent& event);
+	//moves to the first event of given indices and returns it.
+	//k equal to vertices count means the end of algorithm
+	bool seek(int k, int i, int j, StepEvent& event);
+
+	int getVerticesCount() const;
+
+private:
+	const FloydTrace* trace;
+	int verticesCount;
+
+	//position of the last returned event. k == -1 means we're before the first event,
+	//k == verticesCount means we're at the end
+	int k;
+	int i;
+	int j;
+	//0 for the only (or first) event of the cell, 1 for BetterPathApplied following BetterPathFound
+	int phase;
+
+	//states before and after iteration 'loadedIteration'
+	int loadedIteration;
+	int** distancesBefore;
+	int** distancesAfter;
+	int** predecessorsBefore;
+	int** predecessorsAfter;
+
+	//makes before and after matrices hold iteration k
+	void loadIteration(int k);
+	//count of events for i and j at current iteration (2 if better path is found, 1 otherwise)
+	int eventsCount(int i, int j) const;
+	//moves position to the next or previous cell in floydStep order
+	void nextCell();
+	void previousCell();
+	//makes event for the current position
+	void makeEvent(StepEvent& event) const;
+	static void copyMatrix(int** from, int** to, int size);
+};
@@ -0,0 +1,51 @@
+#include "FloydWarshall.h"
+
+namespace
+{
+	template <int N>
+	void solveFixed(int** adjacencyMatrix, int** distancesMatrix, int** predecessorsMatrix)
+	{
+		typename FloydWarshall<N>::Distances adjacency;
+		for (int i = 0; i < N; i++)
+		{
+			for (int j = 0; j < N; j++)
+				adjacency[i][j] = adjacencyMatrix[i][j];
+		}
+		typename FloydWarshall<N>::Result result = FloydWarshall<N>::solve(adjacency);
+		for (int i = 0; i < N; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				distancesMatrix[i][j] = result.distances[i][j];
+				predecessorsMatrix[i][j] = result.predecessors[i][j];
+			}
+		}
+	}
+
+	//the example graph of the menu (from Wikipedia) solved while compiling
+	constexpr int noEdge = FloydWarshall<4>::noEdge;
+	constexpr FloydWarshall<4>::Result example = FloydWarshall<4>::solve({ {
+		{ { 0, noEdge, -2, noEdge } },
+		{ { 4, 0, 3, noEdge } },
+		{ { noEdge, noEdge, 0, 2 } },
+		{ { noEdge, -1, noEdge, 0 } }
+	} });
+	static_assert(example.distances[0][1] == -1 && example.distances[0][3] == 0 && example.distances[1][0] == 4
+		&& example.distances[3][0] == 3 && example.predecessors[0][1] == 3, "FloydWarshall is broken");
+}
+
+bool solveFixedSize(int** adjacencyMatrix, int verticesCount, int** distancesMatrix, int** predecessorsMatrix)
+{
+	switch (verticesCount)
+	{
+	case 2: solveFixed<2>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 3: solveFixed<3>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 4: solveFixed<4>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 5: solveFixed<5>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 6: solveFixed<6>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 7: solveFixed<7>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 8: solveFixed<8>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	case 16: solveFixed<16>(adjacencyMatrix, distancesMatrix, predecessorsMatrix); return true;
+	default: return false;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <limits>
+#include <utility>
+#include <stddef.h>
+
+//Floyd algorithm for a vertices count known while compiling.
+//matrices are std::array, loops over k and i are unrolled by templates (only the j loop stays),
+//and everything is constexpr, so a table can be solved by the compiler:
+//  constexpr auto solved = FloydWarshall<4>::solve(adjacency);
+//the order of relaxations is the same as in DenseFloydSolver, so results are the same too.
+//at runtime DenseFloydSolver switches to it by itself for the sizes solveFixedSize() knows
+template <int N, typename Weight = int>
+class FloydWarshall
+{
+public:
+	typedef std::array<std::array<Weight, N>, N> Distances;
+	typedef std::array<std::array<int, N>, N> Predecessors;
+
+	//weight of a nonexistent edge (INT_MAX for int, like everywhere else)
+	static constexpr Weight noEdge = std::numeric_limits<Weight>::max();
+
+	struct Result
+	{
+		Distances distances;
+		Predecessors predecessors;
+	};
+
+	static constexpr Result solve(const Distances& adjacency)
+	{
+		Result result{};
+		for (int i = 0; i < N; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				result.distances[i][j] = adjacency[i][j];
+				result.predecessors[i][j] = adjacency[i][j] != noEdge ? i : -1;
+			}
+		}
+		iterations(result, std::make_index_sequence<N>());
+		return result;
+	}
+
+private:
+	//one call of rows() for every k
+	template <size_t... K>
+	static constexpr void iterations(Result& result, std::index_sequence<K...>)
+	{
+		(rows<K>(result, std::make_index_sequence<N>()), ...);
+	}
+
+	//one call of relaxRow() for every i
+	template <size_t K, size_t... I>
+	static constexpr void rows(Result& result, std::index_sequence<I...>)
+	{
+		(relaxRow<K, I>(result), ...);
+	}
+
+	template <size_t K, size_t I>
+	static constexpr void relaxRow(Result& result)
+	{
+		Weight distanceIK = result.distances[I][K];
+		//there's nothing to improve in the whole row if i can't reach k
+		if (distanceIK == noEdge)
+			return;
+		for (int j = 0; j < N; j++)
+		{
+			Weight distanceKJ = result.distances[K][j];
+			if (distanceKJ != noEdge && distanceIK + distanceKJ < result.distances[I][j])
+			{
+				result.distances[I][j] = distanceIK + distanceKJ;
+				result.predecessors[I][j] = result.predecessors[K][j];
+			}
+		}
+	}
+};
+
+//solves int** matrices (as FloydSolver has them) with FloydWarshall<verticesCount> if there's one
+//compiled for this size (2 to 8 and 16). Returns false if the size isn't one of them
+bool solveFixedSize(int** adjacencyMatrix, int verticesCount, int** distancesMatrix, int** predecessorsMatrix);
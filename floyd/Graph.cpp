@@ -1,4 +1,5 @@
 #include "Graph.h"
+#include "MatrixAllocator.h"
 #include <limits.h>
 #include <iostream>
 
@@ -10,16 +11,13 @@ Graph::Graph(int** adjacencyMatrix, int verticesCount)
 	this->adjacencyMatrix = adjacencyMatrix;
 	
 	//let's allocate memory needed for those arrays described in .h file
-	this->distancesMatrixBeforeIteration = new int*[verticesCount];
-	this->distancesMatrixAfterIteration = new int*[verticesCount];
-	this->predecessorsMatrixBeforeIteration = new int*[verticesCount];
-	this->predecessorsMatrixAfterIteration = new int*[verticesCount];
+	//(each one is a single block, on huge pages if it's big enough)
+	this->distancesMatrixBeforeIteration = MatrixAllocator::allocate(verticesCount);
+	this->distancesMatrixAfterIteration = MatrixAllocator::allocate(verticesCount);
+	this->predecessorsMatrixBeforeIteration = MatrixAllocator::allocate(verticesCount);
+	this->predecessorsMatrixAfterIteration = MatrixAllocator::allocate(verticesCount);
 	for (int i = 0; i<verticesCount; i++)
 	{
-		this->distancesMatrixAfterIteration[i] = new int[verticesCount];
-		this->distancesMatrixBeforeIteration[i] = new int[verticesCount];
-		this->predecessorsMatrixBeforeIteration[i] = new int[verticesCount];
-		this->predecessorsMatrixAfterIteration[i] = new int[verticesCount];
 		for (int j = 0; j < verticesCount; j++)
 		{
 			//by the way we'll fill up initial distances matrix with adjacency matrix values
@@ -48,17 +46,10 @@ Graph::Graph(int** adjacencyMatrix, int verticesCount)
 Graph::~Graph()
 {
 	//we'll always clean up this mess after us...
-	for (int i = 0; i < verticesCount; i++)
-	{
-		delete[] this->distancesMatrixBeforeIteration[i];
-		delete[] this->distancesMatrixAfterIteration[i];
-		delete[] this->predecessorsMatrixBeforeIteration[i];
-		delete[] this->predecessorsMatrixAfterIteration[i];
-	}
-	delete[] this->distancesMatrixBeforeIteration;
-	delete[] this->distancesMatrixAfterIteration;
-	delete[] this->predecessorsMatrixBeforeIteration;
-	delete[] this->predecessorsMatrixAfterIteration;
+	MatrixAllocator::release(this->distancesMatrixBeforeIteration);
+	MatrixAllocator::release(this->distancesMatrixAfterIteration);
+	MatrixAllocator::release(this->predecessorsMatrixBeforeIteration);
+	MatrixAllocator::release(this->predecessorsMatrixAfterIteration);
 }
 
 Graph::FloydStepResult Graph::floydStep()
@@ -74,9 +65,12 @@ Graph::FloydStepResult Graph::floydStep()
 	{
 		updateIndices();
 		//if indices are same, we can safely update them again (we don't need
-		//path from some vertice to itself)
-		if (i == j)
+		//path from some vertice to itself). With 2 vertices it can happen twice in a row
+		while (i == j && k < verticesCount)
 			updateIndices();
+		//the last update may have performed the last iteration, nothing to compare anymore
+		if (k == verticesCount)
+			return FloydStepResult::EndOfAlgorithm;
 	}
 
 	//if distance in the new iteration is less than that in old
@@ -140,6 +134,18 @@ void Graph::oneIteration()
 	}
 }
 
+bool Graph::skipIteration()
+{
+	if (k == verticesCount)
+		return false;
+	isNotifiedAboutBetterPathFound = false;
+	oneIteration();
+	//indices as if updateIndices has just made the iteration, so the next floydStep starts from its first cell
+	i = 0;
+	j = verticesCount;
+	return k < verticesCount;
+}
+
 void Graph::updateIndices()
 {
 	//we'll decrement j because we need shorter paths shown first
@@ -176,7 +182,7 @@ void Graph::getPath(int start, int finish, std::vector<int> &path, bool old)
 	//if there is predecessor we'll call this function again but with predecessor of 'finish' vertice as a finish.
 	else
 	{
-		getPath(start, predecessors[start][finish], path);
+		getPath(start, predecessors[start][finish], path, old);
 		path.push_back(finish);
 	}
 }
@@ -52,6 +52,10 @@ public:
 	//during the iteration.
 	void getPath(int start, int finish, std::vector<int> &path, bool old=false);
 
+	//makes the next iteration at once, without stepping through its cells (used to skip to the end).
+	//false if there are no iterations left, then floydStep gives EndOfAlgorithm
+	bool skipIteration();
+
 	virtual ~Graph();
 
 private:
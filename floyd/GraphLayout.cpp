@@ -0,0 +1,290 @@
+#include "GraphLayout.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+//ideal length of edge, everything else is measured in it
+#define LAYOUT_EDGE_LENGTH 1.f
+//pull towards the center, so parts of disconnected graph don't fly away
+#define LAYOUT_GRAVITY 0.02f
+//temperature is multiplied by this every iteration, and layout stops when it's this low
+#define LAYOUT_COOLING 0.97f
+#define LAYOUT_MIN_TEMPERATURE 0.005f
+//coincident vertices can't be split by quadtree forever
+#define LAYOUT_MAX_DEPTH 24
+//vertices handed to a thread at once
+#define LAYOUT_CHUNK 256
+
+GraphLayout::GraphLayout(int** adjacencyMatrix, int verticesCount, const std::vector<int>& positionOf)
+{
+	this->adjacencyMatrix = adjacencyMatrix;
+	this->verticesCount = verticesCount;
+	this->iterationsCount = 0;
+	this->maxIterations = 500;
+	this->theta = 0.8f;
+	this->publishedVersion = 0;
+	this->stopRequested = false;
+	this->finished = false;
+
+	//circle of about the size layout will have, so it doesn't have to blow up or shrink much
+	float radius = LAYOUT_EDGE_LENGTH * (float)std::sqrt((double)verticesCount);
+	positions.resize(2 * verticesCount);
+	for (int v = 0; v < verticesCount; v++)
+	{
+		int position = positionOf.empty() ? v : positionOf[v];
+		double angle = 2 * 3.14159265358979 * position / verticesCount;
+		positions[2 * v] = (float)(std::sin(angle) * radius);
+		positions[2 * v + 1] = (float)(-std::cos(angle) * radius);
+	}
+	displacements.resize(2 * verticesCount);
+	published = positions;
+	temperature = radius / 4 + LAYOUT_EDGE_LENGTH;
+}
+
+GraphLayout::~GraphLayout()
+{
+	stop();
+}
+
+void GraphLayout::start()
+{
+	if (thread.joinable())
+		return;
+	stopRequested = false;
+	thread = std::thread(&GraphLayout::run, this);
+}
+
+void GraphLayout::stop()
+{
+	stopRequested = true;
+	if (thread.joinable())
+		thread.join();
+}
+
+bool GraphLayout::isFinished() const
+{
+	return finished;
+}
+
+bool GraphLayout::getPositions(std::vector<float>& positions, int& version)
+{
+	std::lock_guard<std::mutex> lock(publishedMutex);
+	if (version == publishedVersion)
+		return false;
+	positions = published;
+	version = publishedVersion;
+	return true;
+}
+
+void GraphLayout::run()
+{
+	//reading the whole matrix takes a while for big graphs, that's why it's here and not in constructor
+	findNeighbours();
+	while (!stopRequested && !finished)
+		step();
+}
+
+void GraphLayout::findNeighbours()
+{
+	neighbours.assign(verticesCount, std::vector<int>());
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = i + 1; j < verticesCount; j++)
+		{
+			if (adjacencyMatrix[i][j] != infinity || adjacencyMatrix[j][i] != infinity)
+			{
+				neighbours[i].push_back(j);
+				neighbours[j].push_back(i);
+			}
+		}
+	}
+}
+
+void GraphLayout::step()
+{
+	if (finished)
+		return;
+	if ((int)neighbours.size() != verticesCount)
+		findNeighbours();
+	buildTree();
+
+	//every vertice sums its own forces, so threads never write the same place
+	int chunksCount = (verticesCount + LAYOUT_CHUNK - 1) / LAYOUT_CHUNK;
+	parallelFor(chunksCount, [this](int chunk)
+	{
+		int last = std::min((chunk + 1) * LAYOUT_CHUNK, verticesCount);
+		for (int v = chunk * LAYOUT_CHUNK; v < last; v++)
+		{
+			float x = positions[2 * v];
+			float y = positions[2 * v + 1];
+			float forceX = -LAYOUT_GRAVITY * x;
+			float forceY = -LAYOUT_GRAVITY * y;
+			addRepulsion(v, forceX, forceY);
+			//springs pull by square of distance
+			for (unsigned int n = 0; n < neighbours[v].size(); n++)
+			{
+				int u = neighbours[v][n];
+				float dx = positions[2 * u] - x;
+				float dy = positions[2 * u + 1] - y;
+				float distance = std::sqrt(dx * dx + dy * dy);
+				forceX += dx * distance / LAYOUT_EDGE_LENGTH;
+				forceY += dy * distance / LAYOUT_EDGE_LENGTH;
+			}
+			//moving along the force, but not further than temperature
+			float length = std::sqrt(forceX * forceX + forceY * forceY);
+			float scale = length > temperature ? temperature / length : 1.f;
+			displacements[2 * v] = forceX * scale;
+			displacements[2 * v + 1] = forceY * scale;
+		}
+	});
+
+	for (int c = 0; c < 2 * verticesCount; c++)
+		positions[c] += displacements[c];
+	temperature *= LAYOUT_COOLING;
+	iterationsCount++;
+	{
+		std::lock_guard<std::mutex> lock(publishedMutex);
+		published = positions;
+		publishedVersion++;
+	}
+	if (temperature < LAYOUT_MIN_TEMPERATURE * LAYOUT_EDGE_LENGTH || iterationsCount >= maxIterations)
+		finished = true;
+}
+
+void GraphLayout::buildTree()
+{
+	float minX = 0, minY = 0, maxX = 0, maxY = 0;
+	for (int v = 0; v < verticesCount; v++)
+	{
+		float x = positions[2 * v];
+		float y = positions[2 * v + 1];
+		if (v == 0 || x < minX)
+			minX = x;
+		if (v == 0 || x > maxX)
+			maxX = x;
+		if (v == 0 || y < minY)
+			minY = y;
+		if (v == 0 || y > maxY)
+			maxY = y;
+	}
+	cells.clear();
+	Cell root;
+	root.left = minX;
+	root.top = minY;
+	//a bit bigger, so the farthest vertices are inside and not on the border
+	root.size = std::max(maxX - minX, maxY - minY) * 1.001f + LAYOUT_EDGE_LENGTH * 0.001f;
+	root.massX = root.massY = 0;
+	root.mass = 0;
+	root.children = -1;
+	root.vertice = -1;
+	cells.push_back(root);
+	for (int v = 0; v < verticesCount; v++)
+		insert(0, v, 0);
+}
+
+void GraphLayout::insert(int cell, int vertice, int depth)
+{
+	float x = positions[2 * vertice];
+	float y = positions[2 * vertice + 1];
+	//cells vector may grow below, so no references to its elements are kept
+	while (true)
+	{
+		//center of mass moves towards the new vertice
+		Cell& current = cells[cell];
+		current.massX = (current.massX * current.mass + x) / (current.mass + 1);
+		current.massY = (current.massY * current.mass + y) / (current.mass + 1);
+		current.mass++;
+		if (current.mass == 1)
+		{
+			current.vertice = vertice;
+			return;
+		}
+		if (current.children == -1)
+		{
+			//vertices at the same place stay together in one crowded leaf without its own vertice
+			if (depth >= LAYOUT_MAX_DEPTH)
+			{
+				current.vertice = -1;
+				return;
+			}
+			//splitting the leaf, its vertice goes down too
+			int children = (int)cells.size();
+			float half = current.size / 2;
+			float left = current.left, top = current.top;
+			int previous = current.vertice;
+			cells[cell].children = children;
+			cells[cell].vertice = -1;
+			for (int quarter = 0; quarter < 4; quarter++)
+			{
+				Cell child;
+				child.left = left + (quarter & 1) * half;
+				child.top = top + (quarter >> 1) * half;
+				child.size = half;
+				child.massX = child.massY = 0;
+				child.mass = 0;
+				child.children = -1;
+				child.vertice = -1;
+				cells.push_back(child);
+			}
+			float previousX = positions[2 * previous];
+			float previousY = positions[2 * previous + 1];
+			int quarter = (previousX >= left + half ? 1 : 0) + (previousY >= top + half ? 2 : 0);
+			Cell& target = cells[children + quarter];
+			target.massX = previousX;
+			target.massY = previousY;
+			target.mass = 1;
+			target.vertice = previous;
+		}
+		const Cell& parent = cells[cell];
+		float half = parent.size / 2;
+		cell = parent.children + (x >= parent.left + half ? 1 : 0) + (y >= parent.top + half ? 2 : 0);
+		depth++;
+	}
+}
+
+void GraphLayout::addRepulsion(int vertice, float& forceX, float& forceY) const
+{
+	float x = positions[2 * vertice];
+	float y = positions[2 * vertice + 1];
+	const float squaredLength = LAYOUT_EDGE_LENGTH * LAYOUT_EDGE_LENGTH;
+	//walking the tree without recursion
+	int stack[4 * LAYOUT_MAX_DEPTH + 4];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Cell& cell = cells[stack[--top]];
+		if (cell.mass == 0 || cell.vertice == vertice)
+			continue;
+		float dx = x - cell.massX;
+		float dy = y - cell.massY;
+		float squaredDistance = dx * dx + dy * dy;
+		//far enough cell (or leaf) is pushing as one body of its whole mass
+		if (cell.children == -1 || cell.size * cell.size < theta * theta * squaredDistance)
+		{
+			int mass = cell.mass;
+			//the vertice itself may be in a crowded leaf at the bottom
+			if (cell.children == -1 && cell.vertice == -1 && squaredDistance < 1e-12f)
+			{
+				//vertices at one place are pushed apart in directions of their own
+				float angle = vertice * 2.39996323f;
+				dx = std::cos(angle) * 1e-3f;
+				dy = std::sin(angle) * 1e-3f;
+				squaredDistance = dx * dx + dy * dy;
+				mass--;
+			}
+			else if (squaredDistance < 1e-12f)
+				continue;
+			//pushing by inverse of distance
+			float factor = mass * squaredLength / squaredDistance;
+			forceX += dx * factor;
+			forceY += dy * factor;
+			continue;
+		}
+		for (int child = 0; child < 4; child++)
+			stack[top++] = cell.children + child;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+//force-directed placement of vertices for big graphs, where a circle is just a hairball.
+//connected vertices pull each other like springs and all vertices push each other away;
+//the pushing is approximated by Barnes-Hut quadtree, so an iteration is O(V log V) instead of O(V^2),
+//and forces on vertices are counted on all hardware threads.
+//iterations run on a thread of their own, after every one of them positions are published,
+//so the window takes the latest ones each frame and sees the picture getting better.
+class GraphLayout
+{
+public:
+	//vertices start on a circle in order of positionOf (by indices if it's empty)
+	GraphLayout(int** adjacencyMatrix, int verticesCount, const std::vector<int>& positionOf = std::vector<int>());
+	virtual ~GraphLayout();
+
+	//runs iterations on the layout thread until it settles
+	void start();
+	//asks the layout thread to stop and waits for it
+	void stop();
+	//one iteration on the calling thread (when there's no layout thread)
+	void step();
+
+	//copies the latest positions (x and y of every vertice) if they're newer than version, and updates version
+	bool getPositions(std::vector<float>& positions, int& version);
+	//true when the movement has cooled down and positions won't change anymore
+	bool isFinished() const;
+
+	int verticesCount;
+	int iterationsCount;
+	//maximum iterations, the layout settles earlier usually
+	int maxIterations;
+	//cells seen from vertice at an angle less than this are taken as a single mass
+	float theta;
+
+private:
+	//cell of quadtree: its square, mass (count of vertices) and center of mass
+	struct Cell
+	{
+		float left, top, size;
+		float massX, massY;
+		int mass;
+		//first of 4 children, -1 for leaf
+		int children;
+		//vertice in leaf, -1 if it's empty
+		int vertice;
+	};
+
+	void buildTree();
+	void insert(int cell, int vertice, int depth);
+	void addRepulsion(int vertice, float& forceX, float& forceY) const;
+	//neighbours both ways, springs don't care about direction
+	void findNeighbours();
+	void run();
+
+	int** adjacencyMatrix;
+	std::vector<std::vector<int>> neighbours;
+	std::vector<float> positions;
+	std::vector<float> displacements;
+	std::vector<Cell> cells;
+	//how far a vertice may move in one iteration, goes down every time
+	float temperature;
+
+	std::mutex publishedMutex;
+	std::vector<float> published;
+	int publishedVersion;
+
+	std::thread thread;
+	std::atomic<bool> stopRequested;
+	std::atomic<bool> finished;
+};
@@ -2,6 +2,7 @@
 #include "GraphVisualizer.h"
 #include "Graph.h"
 #include "LineShape.h"
+#include "VertexOrdering.h"
 #include <iostream>
 #include <cstring>
 #include <vector>
@@ -22,15 +23,25 @@
 #define BAD_PATH_SHOW_TIME 2000
 #define GOOD_PATH_SHOW_TIME 2000
 #define NO_PATH_SHOW_TIME 200
+//playback speed limits, speed is doubled or halved by +/- keys
+#define MIN_PLAYBACK_SPEED 0.125f
+#define MAX_PLAYBACK_SPEED 64.f
+//how many events we'll drain per frame while skipping to the end
+//(so the window stays responsive even for huge graphs)
+#define SKIP_EVENTS_PER_FRAME 4096
 //margin of indices from top and left edges of the window
 #define INDICES_MARGIN 30.f
 //margin of back button from bottom and left edges of the window
 #define BACK_BUTTON_MARGIN 30.f
+//graphs with more vertices than this get force-directed layout instead of the circle
+#define LAYOUT_MIN_VERTICES 24
+//margin of laid out graph from edges of the window
+#define LAYOUT_MARGIN (VERTICE_RADIUS * 2.f)
 
 using namespace sf;
 using namespace std;
 
-GraphVisualizer::GraphVisualizer(Graph* graph, RenderWindow* window, int graphRadius)
+GraphVisualizer::GraphVisualizer(Graph* graph, RenderWindow* window, int graphRadius, FloydTraceReplayer* replayer)
 {
 	//so we'll set our graph, window and graph radius
 	this->window = window;
@@ -46,7 +57,38 @@ GraphVisualizer::GraphVisualizer(Graph* graph, RenderWindow* window, int graphRa
 	this->font = font;
 	this->clock = Clock();
 	this->beforeUpdate = Time();
-	this->lastResult = Graph::FloydStepResult::NoPathFound;
+	//until the first event arrives we'll show indices graph starts with
+	this->lastEvent.result = Graph::FloydStepResult::NoPathFound;
+	this->lastEvent.k = graph->k;
+	this->lastEvent.i = graph->i;
+	this->lastEvent.j = graph->j;
+	this->playbackSpeed = 1.f;
+	this->isPaused = false;
+	this->isSkippingToEnd = false;
+	this->replayer = replayer;
+	this->layout = nullptr;
+	this->layoutVersion = -1;
+	if (replayer != nullptr)
+	{
+		//nothing to run, everything is in the trace already
+		this->solver = nullptr;
+		this->recorder = nullptr;
+		this->source = replayer;
+	}
+	else
+	{
+		//from now on graph matrices belong to solver thread,
+		//and it will record every iteration it makes (if the graph isn't too big for that)
+		this->solver = new FloydSolverThread(graph);
+		this->recorder = nullptr;
+		if (graph->verticesCount <= TRACE_MAX_RECORDED_VERTICES)
+		{
+			this->recorder = new FloydTraceRecorder(&trace, graph->verticesCount);
+			this->solver->setRecorder(recorder, DEFAULT_TRACE_FILE_NAME);
+		}
+		this->solver->start();
+		this->source = solver;
+	}
 
 	//to be able to detect if mouse is hovering above the border, we need to store it as a member of class
 	buttonText.setFillColor(Color::Black);
@@ -66,52 +108,79 @@ GraphVisualizer::GraphVisualizer(Graph* graph, RenderWindow* window, int graphRa
 
 GraphVisualizer::~GraphVisualizer()
 {
-	//all we need to clean up is font... if it's loaded of course
+	//stopping solver first, graph may be destroyed right after us
+	if (this->solver != nullptr)
+		delete this->solver;
+	if (this->recorder != nullptr)
+		delete this->recorder;
+	//layout thread is stopped by its destructor
+	if (this->layout != nullptr)
+		delete this->layout;
+	//the rest is font... if it's loaded of course
 	if (this->font != nullptr)
 		delete this->font;
 }
 
 void GraphVisualizer::drawGraph()
 {
+	//positions may have got better since the last frame
+	updateVerticeCoords();
 	//drawing all edges and vertices of a graph
 	drawEdges();
 	drawVertices();
-	//check the time elapsed since last frame
-	Time time = clock.getElapsedTime();
-	//if it's time to draw next step, let's do it!
-	if (time > beforeUpdate)
+	if (isSkippingToEnd && replayer != nullptr)
 	{
-		lastResult = graph->floydStep();
-		clock.restart();
-		updateTime();
+		//trace can jump right to the end
+		replayer->seek(replayer->getVerticesCount(), 0, 0, lastEvent);
+		isSkippingToEnd = false;
+	}
+	else if (isSkippingToEnd)
+	{
+		//taking a limited batch of events per frame, the solver keeps running meanwhile
+		StepEvent event;
+		for (int n = 0; n < SKIP_EVENTS_PER_FRAME && lastEvent.result != Graph::FloydStepResult::EndOfAlgorithm; n++)
+		{
+			if (!source->pollEvent(event))
+				break;
+			lastEvent = std::move(event);
+		}
+		if (lastEvent.result == Graph::FloydStepResult::EndOfAlgorithm)
+			isSkippingToEnd = false;
+	}
+	//check the time elapsed since last step, scaled by playback speed
+	else if (!isPaused && clock.getElapsedTime().asSeconds() * playbackSpeed > beforeUpdate.asSeconds())
+	{
+		//if it's time to draw next step and solver has already made it, let's do it!
+		//otherwise we'll just keep showing the last one until the next frame
+		if (source->pollEvent(lastEvent))
+		{
+			clock.restart();
+			updateTime();
+		}
 	}
-	//it will hold the path to draw
-	vector<int> path;
-	//we'll draw different things depending on what was the result of floydStep
-	switch (lastResult)
+	//we'll draw different things depending on what was the result of floydStep.
+	//paths are already constructed by solver thread
+	switch (lastEvent.result)
 	{
 	case Graph::FloydStepResult::BetterPathApplied:
 		//if it was better path, then we'll draw it with green color
-		graph->getPath(graph->i, graph->j, path);
-		drawEdges(path, Color::Green);
-		drawVertices(path, Color::Green);
+		drawEdges(lastEvent.path, Color::Green);
+		drawVertices(lastEvent.path, Color::Green);
 		break;
 	case Graph::FloydStepResult::BetterPathFound:
-		//if it was bad path, we'll draw it in red, getting it from old predecessor matrix
-		graph->getPath(graph->i, graph->j, path, true);
-		drawEdges(path, Color::Red);
-		drawVertices(path, Color::Red);
+		//if it was bad path, we'll draw it in red (it's got from old predecessor matrix)
+		drawEdges(lastEvent.path, Color::Red);
+		drawVertices(lastEvent.path, Color::Red);
 		break;
 	case Graph::FloydStepResult::PathFoundAndApplied:
 		//if it was new path, we'll draw it with cyan
-		graph->getPath(graph->i, graph->j, path);
-		drawEdges(path, Color::Cyan);
-		drawVertices(path, Color::Cyan);
+		drawEdges(lastEvent.path, Color::Cyan);
+		drawVertices(lastEvent.path, Color::Cyan);
 		break;
 	case Graph::FloydStepResult::NoPathFound:
 		//if nothing changed we'll just highlight corresponding vertices
-		drawVertice(graph->i, Color::Yellow);
-		drawVertice(graph->j, Color::Yellow);
+		drawVertice(lastEvent.i, Color::Yellow);
+		drawVertice(lastEvent.j, Color::Yellow);
 		break;
 	case Graph::FloydStepResult::EndOfAlgorithm:
 		//if we're done, we won't draw something special
@@ -122,10 +191,85 @@ void GraphVisualizer::drawGraph()
 	drawBackButton();
 }
 
+void GraphVisualizer::handleEvent(const Event& event)
+{
+	if (event.type != Event::KeyPressed)
+		return;
+	switch (event.key.code)
+	{
+	case Keyboard::Add:
+	case Keyboard::Equal:
+		//faster
+		if (playbackSpeed < MAX_PLAYBACK_SPEED)
+			playbackSpeed *= 2.f;
+		break;
+	case Keyboard::Subtract:
+	case Keyboard::Dash:
+		//slower
+		if (playbackSpeed > MIN_PLAYBACK_SPEED)
+			playbackSpeed /= 2.f;
+		break;
+	case Keyboard::Space:
+		isPaused = !isPaused;
+		break;
+	case Keyboard::End:
+		isSkippingToEnd = true;
+		//live solver makes the rest of iterations at once instead of publishing every cell
+		if (solver != nullptr)
+			solver->skipToEnd();
+		break;
+	case Keyboard::O:
+		//related vertices next to each other on the circle (and at the start of layout), or back to indices
+		if (verticePositions.empty())
+			setVerticesOrder(VertexOrdering(graph->adjacencyMatrix, graph->verticesCount, VertexOrdering::ReverseCuthillMcKee).positionOf);
+		else
+			setVerticesOrder(vector<int>());
+		break;
+	default:
+		break;
+	}
+
+	//the rest is seeking, which only recorded trace can do
+	if (replayer == nullptr)
+		return;
+	bool isMoved = false;
+	switch (event.key.code)
+	{
+	case Keyboard::Left:
+		//one step back
+		isMoved = replayer->stepBack(lastEvent);
+		isPaused = true;
+		break;
+	case Keyboard::Right:
+		//one step forward
+		isMoved = replayer->pollEvent(lastEvent);
+		isPaused = true;
+		break;
+	case Keyboard::PageUp:
+		//to the beginning of previous iteration
+		isMoved = replayer->seek(lastEvent.k - 1, 0, replayer->getVerticesCount() - 1, lastEvent);
+		break;
+	case Keyboard::PageDown:
+		//to the beginning of next iteration
+		isMoved = replayer->seek(lastEvent.k + 1, 0, replayer->getVerticesCount() - 1, lastEvent);
+		break;
+	case Keyboard::Home:
+		isMoved = replayer->seek(0, 0, replayer->getVerticesCount() - 1, lastEvent);
+		break;
+	default:
+		break;
+	}
+	if (isMoved)
+	{
+		clock.restart();
+		updateTime();
+	}
+}
+
 void GraphVisualizer::updateTime()
 {
-	//update time before next floydStep call dependently of what was returned from current
-	switch (lastResult)
+	//update time before next event dependently of what was in the current one
+	switch (lastEvent.result)
 	{
 	case Graph::FloydStepResult::BetterPathApplied:
 		beforeUpdate = milliseconds(GOOD_PATH_SHOW_TIME);
@@ -199,7 +343,7 @@ void GraphVisualizer::drawIndices()
 	k.setFillColor(Color::Black);
 	k.setStyle(Text::Bold);
 	k.setFont(*font);
-	k.setString("k = " + to_string(this->graph->k));
+	k.setString("k = " + to_string(lastEvent.k));
 	k.setPosition(INDICES_MARGIN, INDICES_MARGIN);
 	this->window->draw(k);
 
@@ -211,7 +355,7 @@ void GraphVisualizer::drawIndices()
 	i.setFillColor(Color::Black);
 	i.setStyle(Text::Bold);
 	i.setFont(*font);
-	i.setString("i = " + to_string(this->graph->i));
+	i.setString("i = " + to_string(lastEvent.i));
 	//setting position relatively to k
 	i.setPosition(kBoundingRect.left, kBoundingRect.height + kBoundingRect.top);
 	this->window->draw(i);
@@ -223,9 +367,26 @@ void GraphVisualizer::drawIndices()
 	j.setFillColor(Color::Black);
 	j.setStyle(Text::Bold);
 	j.setFont(*font);
-	j.setString("j = " + to_string(this->graph->j));
+	j.setString("j = " + to_string(lastEvent.j));
 	j.setPosition(iBoundingRect.left, iBoundingRect.height + iBoundingRect.top);
 	this->window->draw(j);
+
+	//and playback state under them
+	FloatRect jBoundingRect = j.getGlobalBounds();
+
+	Text speed;
+	speed.setFillColor(Color::Black);
+	speed.setFont(*font);
+	if (isSkippingToEnd)
+		speed.setString("skipping...");
+	else if (isPaused)
+		speed.setString("paused");
+	else if (playbackSpeed < 1.f)
+		speed.setString("speed x1/" + to_string((int)(1.f / playbackSpeed)));
+	else
+		speed.setString("speed x" + to_string((int)playbackSpeed));
+	speed.setPosition(jBoundingRect.left, jBoundingRect.height + jBoundingRect.top);
+	this->window->draw(speed);
 }
 
 void GraphVisualizer::drawBackButton()
@@ -241,14 +402,85 @@ void GraphVisualizer::drawBackButton()
 	this->window->draw(buttonText);
 }
 
+void GraphVisualizer::setVerticesOrder(const vector<int>& positionOf)
+{
+	//only the places change, vertices are still drawn and labeled by their own indices
+	this->verticePositions = positionOf;
+	//layout starts from the circle, so it's started again from the new one
+	if (this->layout != nullptr)
+	{
+		delete this->layout;
+		this->layout = nullptr;
+	}
+	this->verticeCoords.clear();
+}
+
+void GraphVisualizer::updateVerticeCoords()
+{
+	int verticesCount = this->graph->verticesCount;
+	Vector2u windowSize = this->window->getSize();
+	bool isResized = windowSize != this->coordsWindowSize || (int)this->verticeCoords.size() != verticesCount;
+	if (this->layout == nullptr && verticesCount > LAYOUT_MIN_VERTICES)
+	{
+		//it only reads adjacency matrix, which never changes
+		this->layout = new GraphLayout(this->graph->adjacencyMatrix, verticesCount, this->verticePositions);
+		this->layout->start();
+		this->layoutVersion = -1;
+	}
+
+	if (this->layout != nullptr)
+	{
+		//nothing to do if there's no new positions and the window is the same
+		if (!this->layout->getPositions(this->layoutPositions, this->layoutVersion) && !isResized)
+			return;
+		//layout has its own units, so it's scaled to fit the window keeping proportions
+		float minX = 0, minY = 0, maxX = 0, maxY = 0;
+		for (int v = 0; v < verticesCount; v++)
+		{
+			float x = layoutPositions[2 * v], y = layoutPositions[2 * v + 1];
+			if (v == 0 || x < minX)
+				minX = x;
+			if (v == 0 || x > maxX)
+				maxX = x;
+			if (v == 0 || y < minY)
+				minY = y;
+			if (v == 0 || y > maxY)
+				maxY = y;
+		}
+		float scaleX = maxX > minX ? (windowSize.x - 2 * LAYOUT_MARGIN) / (maxX - minX) : 1.f;
+		float scaleY = maxY > minY ? (windowSize.y - 2 * LAYOUT_MARGIN) / (maxY - minY) : 1.f;
+		float scale = scaleX < scaleY ? scaleX : scaleY;
+		this->verticeCoords.resize(verticesCount);
+		for (int v = 0; v < verticesCount; v++)
+		{
+			this->verticeCoords[v] = Vector2f((layoutPositions[2 * v] - (minX + maxX) / 2) * scale + windowSize.x / 2.f,
+				(layoutPositions[2 * v + 1] - (minY + maxY) / 2) * scale + windowSize.y / 2.f);
+		}
+	}
+	else if (isResized)
+	{
+		//complicated math is going here ╰( ͡° ͜ʖ ͡° )つ──☆*:・ﾟ
+		//in short we're getting the angle of the vertice on the circle
+		//then we're calculating coordinates using sine, cosine and graph circle radius
+		//then we're moving it at the center of the window because 0 0 coordinates are top left corner
+		//vertices go round the circle in the order given by setVerticesOrder, if any
+		this->verticeCoords.resize(verticesCount);
+		for (int v = 0; v < verticesCount; v++)
+		{
+			int position = verticePositions.empty() ? v : verticePositions[v];
+			double angle = 2 * M_PI * position / verticesCount;
+			this->verticeCoords[v] = Vector2f((float)(sin(angle)*this->graphRadius + (windowSize.x / 2)), (float)(-cos(angle)*this->graphRadius + (windowSize.y / 2)));
+		}
+	}
+	this->coordsWindowSize = windowSize;
+}
+
 Vector2f GraphVisualizer::getVerticeCoords(int verticeIndex)
 {
-	//complicated math is going here ╰( ͡° ͜ʖ ͡° )つ──☆*:・ﾟ
-	//in short we're getting the angle of the vertice on the circle
-	//then we're calculating coordinates using sine, cosine and graph circle radius
-	//then we're moving it at the center of the window because 0 0 coordinates are top left corner
-	double angle = (360 / this->graph->verticesCount*verticeIndex)*M_PI / 180;
-	return Vector2f((float)(sin(angle)*this->graphRadius + (this->window->getSize().x / 2)), (float)(-cos(angle)*this->graphRadius + (this->window->getSize().y / 2)));
+	//coordinates are counted once and then taken from cache, drawGraph keeps them fresh
+	if ((int)this->verticeCoords.size() != this->graph->verticesCount)
+		updateVerticeCoords();
+	return this->verticeCoords[verticeIndex];
 }
 
 void GraphVisualizer::drawVertice(int index, Color color)
@@ -1,15 +1,21 @@
 #pragma once
 #include "Graph.h"
+#include "FloydSolverThread.h"
+#include "FloydTraceReplayer.h"
+#include "GraphLayout.h"
 #include <SFML/Graphics.hpp>
 
 class GraphVisualizer
 {
 public:
 
-	GraphVisualizer(Graph* graph, sf::RenderWindow* window, int graphRadius);
+	//if replayer is given, steps are taken from it instead of running the algorithm
+	//(graph is used only to draw vertices and edges then)
+	GraphVisualizer(Graph* graph, sf::RenderWindow* window, int graphRadius, FloydTraceReplayer* replayer = nullptr);
 	virtual ~GraphVisualizer();
 	
 	void drawGraph();//draws graph to window
+	void handleEvent(const sf::Event& event); //reacts to playback keys (speed, pause, skip to end, vertices order, seeking in replay)
 	void drawVertice(int index, sf::Color color); //draws vertice by given index and of given color
 	void drawVertices(); //draws all graph vertices
 	void drawVertices(std::vector<int> path, sf::Color color); //draws vertices on path of given color
@@ -17,12 +23,13 @@ public:
 	void drawEdge(sf::Vector2f& fromCoords, sf::Vector2f& toCoords, int weight, sf::Color color); //same but for points, not vertice indices
 	void drawEdges(); //draws all graph edges
 	void drawEdges(std::vector<int> path, sf::Color color); //draws edges on given path of given color
-	void drawIndices(); //draws current graph indices
+	void drawIndices(); //draws indices of the last shown step and playback speed
 	void drawBackButton(); //draws back button
 
 	bool areCoordsInBackButton(int x, int y); //checks if given x and y are inside of back button
 
-	sf::Vector2f getVerticeCoords(int verticeIndex); //gets coordinates of vertice by its index
+	void setVerticesOrder(const std::vector<int>& positionOf); //places vertices round the circle by given positions instead of indices (big graphs start their layout from it)
+	sf::Vector2f getVerticeCoords(int verticeIndex); //gets coordinates of vertice by its index (taken from cache)
 	//gets normal vector of given length relatively to straight line between two points
 	static sf::Vector2f getNormalVectorFromPoints(sf::Vector2f first, sf::Vector2f second, float normalLength);
 
@@ -32,10 +39,33 @@ protected:
 private:
 	//window to draw on
 	sf::RenderWindow* window;
-	//graph to draw
+	//graph to draw. Its matrices belong to solver thread, we only read
+	//adjacency matrix and vertices count from here, which never change
 	Graph* graph;
+	//thread running floyd algorithm and publishing its steps (only when not replaying)
+	FloydSolverThread* solver;
+	//recorded trace being replayed (only when replaying)
+	FloydTraceReplayer* replayer;
+	//one of the two above we take events from
+	StepEventSource* source;
+	//live run is recorded to trace, which solver thread saves to file when the algorithm ends
+	//(null recorder if the graph is too big to be recorded)
+	FloydTrace trace;
+	FloydTraceRecorder* recorder;
 	//radius of vertice circle
 	int graphRadius;
+	//position of every vertice on the circle (empty if it's the index itself)
+	std::vector<int> verticePositions;
+	//force-directed layout of big graphs, it's refined on its own thread (null for small graphs, they stay on the circle)
+	GraphLayout* layout;
+	//the latest positions taken from layout and their version
+	std::vector<float> layoutPositions;
+	int layoutVersion;
+	//coordinates of every vertice in the window, counted again only if layout or window size has changed
+	std::vector<sf::Vector2f> verticeCoords;
+	sf::Vector2u coordsWindowSize;
+	//takes new positions from layout (or the circle) to verticeCoords
+	void updateVerticeCoords();
 
 	//font of all text
 	sf::Font* font;
@@ -44,12 +74,17 @@ private:
 	sf::Clock clock;
 	//how much should pass before next floydStep call
 	sf::Time beforeUpdate;
-	//update beforeUpdate time to reflect floydStep call result
+	//update beforeUpdate time to reflect last event result
 	void updateTime();
-	//last floydStep call result
-	//we'll save what has floydStep returned last time so we can draw graph multiple times
-	//while clock is ticking without calling floydStep
-	Graph::FloydStepResult lastResult;
+	//last event taken from solver
+	//we'll keep it so we can draw graph multiple times
+	//while clock is ticking without taking the next one
+	StepEvent lastEvent;
+	//show times are divided by this value
+	float playbackSpeed;
+	bool isPaused;
+	//if set, we're draining events without showing them until the end of algorithm
+	bool isSkippingToEnd;
 	//text of backButton
 	sf::Text buttonText;
 	//rectangle around text of backButton
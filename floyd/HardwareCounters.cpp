@@ -0,0 +1,97 @@
+#include "HardwareCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+
+namespace
+{
+	//opens a counter of cache event for this process and its future threads, -1 if not allowed
+	int openCacheEvent(unsigned long long cache, unsigned long long result)
+	{
+		perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = PERF_TYPE_HW_CACHE;
+		attributes.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+		attributes.disabled = 1;
+		attributes.inherit = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		return (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+	}
+
+	long long readEvent(int event)
+	{
+		long long count;
+		if (event < 0 || read(event, &count, sizeof(count)) != sizeof(count))
+			return -1;
+		return count;
+	}
+}
+
+HardwareCounters::HardwareCounters()
+{
+	tlbMissesCount = -1;
+	remoteAccessesCount = -1;
+	tlbMissesEvent = openCacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS);
+	//misses of the "node" cache are accesses to memory of other nodes
+	remoteAccessesEvent = openCacheEvent(PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_RESULT_MISS);
+}
+
+HardwareCounters::~HardwareCounters()
+{
+	if (tlbMissesEvent >= 0)
+		close(tlbMissesEvent);
+	if (remoteAccessesEvent >= 0)
+		close(remoteAccessesEvent);
+}
+
+void HardwareCounters::start()
+{
+	int events[] = { tlbMissesEvent, remoteAccessesEvent };
+	for (int e = 0; e < 2; e++)
+	{
+		if (events[e] >= 0)
+		{
+			ioctl(events[e], PERF_EVENT_IOC_RESET, 0);
+			ioctl(events[e], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void HardwareCounters::stop()
+{
+	int events[] = { tlbMissesEvent, remoteAccessesEvent };
+	for (int e = 0; e < 2; e++)
+	{
+		if (events[e] >= 0)
+			ioctl(events[e], PERF_EVENT_IOC_DISABLE, 0);
+	}
+	tlbMissesCount = readEvent(tlbMissesEvent);
+	remoteAccessesCount = readEvent(remoteAccessesEvent);
+}
+#else
+HardwareCounters::HardwareCounters()
+{
+	tlbMissesCount = -1;
+	remoteAccessesCount = -1;
+	tlbMissesEvent = -1;
+	remoteAccessesEvent = -1;
+}
+
+HardwareCounters::~HardwareCounters()
+{
+}
+
+void HardwareCounters::start()
+{
+}
+
+void HardwareCounters::stop()
+{
+}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+//processor counters of the memory behaviour of this process between start() and stop(),
+//threads started after start() are counted too.
+//they're read through perf events on Linux; elsewhere, or if the system doesn't allow it
+//(e.g. in a virtual machine), counts stay -1
+class HardwareCounters
+{
+public:
+	HardwareCounters();
+	~HardwareCounters();
+
+	void start();
+	void stop();
+
+	//data TLB misses on loads
+	long long tlbMissesCount;
+	//loads served by memory of another NUMA node
+	long long remoteAccessesCount;
+
+private:
+	int tlbMissesEvent;
+	int remoteAccessesEvent;
+};
@@ -0,0 +1,184 @@
+#include "LandmarkOracle.h"
+#include "SourcesSolver.h"
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+LandmarkOracle::LandmarkOracle(int** adjacencyMatrix, int verticesCount, int landmarksCount, Selection selection)
+{
+	this->adjacencyMatrix = adjacencyMatrix;
+	this->verticesCount = verticesCount;
+	this->landmarksCount = std::max(0, std::min(landmarksCount, verticesCount));
+	this->selection = selection;
+	this->settledCount = 0;
+}
+
+bool LandmarkOracle::prepare()
+{
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (i != j && adjacencyMatrix[i][j] < 0)
+				return false;
+		}
+	}
+
+	landmarks.clear();
+	distancesFrom.assign((size_t)landmarksCount * verticesCount, infinity);
+	distancesTo.assign((size_t)landmarksCount * verticesCount, infinity);
+
+	std::vector<int> degrees(verticesCount, 0);
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (i != j && adjacencyMatrix[i][j] != infinity)
+			{
+				degrees[i]++;
+				degrees[j]++;
+			}
+		}
+	}
+	std::vector<int> byDegree(verticesCount);
+	for (int v = 0; v < verticesCount; v++)
+		byDegree[v] = v;
+	std::stable_sort(byDegree.begin(), byDegree.end(), [&degrees](int a, int b) { return degrees[a] > degrees[b]; });
+
+	//how far every vertice is from the landmarks picked so far (both ways), unreachable ones are the farthest
+	std::vector<long long> closeness(verticesCount, LLONG_MAX);
+	std::vector<bool> isLandmark(verticesCount, false);
+	for (int l = 0; l < landmarksCount; l++)
+	{
+		int landmark = byDegree[l];
+		if (selection == FarthestPoint && l > 0)
+		{
+			landmark = -1;
+			for (int v = 0; v < verticesCount; v++)
+			{
+				if (!isLandmark[v] && (landmark == -1 || closeness[v] > closeness[landmark]))
+					landmark = v;
+			}
+		}
+		//the first farthest point landmark is the best connected vertice
+		landmarks.push_back(landmark);
+		isLandmark[landmark] = true;
+
+		int* from = &distancesFrom[(size_t)l * verticesCount];
+		int* to = &distancesTo[(size_t)l * verticesCount];
+		SourcesSolver::findDistances(adjacencyMatrix, verticesCount, landmark, false, nullptr, from, nullptr);
+		SourcesSolver::findDistances(adjacencyMatrix, verticesCount, landmark, true, nullptr, to, nullptr);
+		for (int v = 0; v < verticesCount; v++)
+		{
+			long long distance = std::min(from[v] == infinity ? LLONG_MAX : (long long)from[v], to[v] == infinity ? LLONG_MAX : (long long)to[v]);
+			closeness[v] = std::min(closeness[v], distance);
+		}
+	}
+	return true;
+}
+
+int LandmarkOracle::getLowerBound(int s, int t) const
+{
+	int bound = 0;
+	for (int l = 0; l < (int)landmarks.size(); l++)
+	{
+		const int* to = &distancesTo[(size_t)l * verticesCount];
+		const int* from = &distancesFrom[(size_t)l * verticesCount];
+		//t reaches the landmark, but s doesn't - then s can't reach t either
+		if ((to[s] == infinity && to[t] != infinity) || (from[s] != infinity && from[t] == infinity))
+			return infinity;
+		if (to[s] != infinity && to[t] != infinity)
+			bound = std::max(bound, to[s] - to[t]);
+		if (from[s] != infinity && from[t] != infinity)
+			bound = std::max(bound, from[t] - from[s]);
+	}
+	return bound;
+}
+
+int LandmarkOracle::getUpperBound(int s, int t) const
+{
+	if (s == t)
+		return 0;
+	long long bound = LLONG_MAX;
+	for (int l = 0; l < (int)landmarks.size(); l++)
+	{
+		int toLandmark = distancesTo[(size_t)l * verticesCount + s];
+		int fromLandmark = distancesFrom[(size_t)l * verticesCount + t];
+		if (toLandmark != infinity && fromLandmark != infinity)
+			bound = std::min(bound, (long long)toLandmark + fromLandmark);
+	}
+	return bound >= infinity ? infinity : (int)bound;
+}
+
+int LandmarkOracle::getDistance(int s, int t)
+{
+	return search(s, t, nullptr);
+}
+
+void LandmarkOracle::getPath(int s, int t, std::vector<int>& path)
+{
+	path.clear();
+	search(s, t, &path);
+}
+
+int LandmarkOracle::search(int s, int t, std::vector<int>* path)
+{
+	settledCount = 0;
+	if (s == t)
+	{
+		if (path != nullptr)
+			path->push_back(s);
+		return 0;
+	}
+	if (getLowerBound(s, t) == infinity)
+		return infinity;
+
+	//A* keeps the queue ordered by distance + lower bound to t
+	std::vector<int> distances(verticesCount, infinity);
+	std::vector<int> predecessors(verticesCount, -1);
+	std::vector<int> bounds(verticesCount, -1);
+	std::vector<char> isSettled(verticesCount, 0);
+	typedef std::pair<long long, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	distances[s] = 0;
+	bounds[s] = getLowerBound(s, t);
+	queue.push(Entry(bounds[s], s));
+
+	while (!queue.empty())
+	{
+		int u = queue.top().second;
+		queue.pop();
+		//the same vertice may be queued more than once, only the first time counts
+		if (isSettled[u])
+			continue;
+		isSettled[u] = 1;
+		settledCount++;
+		if (u == t)
+			break;
+		const int* edges = adjacencyMatrix[u];
+		for (int v = 0; v < verticesCount; v++)
+		{
+			if (v == u || isSettled[v] || edges[v] == infinity || distances[u] + edges[v] >= distances[v])
+				continue;
+			if (bounds[v] == -1)
+				bounds[v] = getLowerBound(v, t);
+			//v can't reach t, no point in going there
+			if (bounds[v] == infinity)
+				continue;
+			distances[v] = distances[u] + edges[v];
+			predecessors[v] = u;
+			queue.push(Entry((long long)distances[v] + bounds[v], v));
+		}
+	}
+
+	if (distances[t] != infinity && path != nullptr)
+	{
+		for (int v = t; v != -1; v = predecessors[v])
+			path->push_back(v);
+		std::reverse(path->begin(), path->end());
+	}
+	return distances[t];
+}
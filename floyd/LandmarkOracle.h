@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+
+//answers distance queries on graphs too big to solve all pairs.
+//a few landmark vertices are picked, and distances from every landmark and to every landmark
+//are stored (L x V each). By triangle inequality they bound any distance in O(L):
+//  d(s, t) >= d(s, l) - d(t, l),  d(s, t) >= d(l, t) - d(l, s),  d(s, t) <= d(s, l) + d(l, t).
+//exact queries are A* over the adjacency matrix with the lower bound to t as its heuristic (ALT),
+//which lets it settle far fewer vertices than Dijkstra.
+//weights must be nonnegative.
+class LandmarkOracle
+{
+public:
+	enum Selection
+	{
+		FarthestPoint, //every next landmark is the vertice farthest from those already picked
+		Degree //vertices with the most edges
+	};
+
+	LandmarkOracle(int** adjacencyMatrix, int verticesCount, int landmarksCount = 8, Selection selection = FarthestPoint);
+
+	//picks landmarks and finds their distances. False if there's a negative weight
+	bool prepare();
+
+	//bounds of distance from s to t, infinity (INT_MAX) if it's known there's no path
+	int getLowerBound(int s, int t) const;
+	int getUpperBound(int s, int t) const;
+
+	//exact distance from s to t (distance to itself is 0), infinity if there's no path
+	int getDistance(int s, int t);
+	//exact shortest path from s to t, empty if there's none
+	void getPath(int s, int t, std::vector<int>& path);
+
+	//original adjacency matrix of graph (not owned)
+	int** adjacencyMatrix;
+	int verticesCount;
+	int landmarksCount;
+	Selection selection;
+
+	std::vector<int> landmarks;
+	//vertices settled by the last exact query, to see how much the landmarks have helped
+	int settledCount;
+
+private:
+	//distances from every landmark to every vertice and from every vertice to every landmark,
+	//landmark by landmark, verticesCount each
+	std::vector<int> distancesFrom;
+	std::vector<int> distancesTo;
+
+	//A* from s to t, fills path if it's given
+	int search(int s, int t, std::vector<int>* path);
+};
@@ -0,0 +1,54 @@
+#include "LocalTransport.h"
+
+LocalTransportHub::LocalTransportHub(int size)
+	: mailboxes(size)
+{
+	this->size = size;
+	for (int rank = 0; rank < size; rank++)
+	{
+		mailboxes[rank].messages.resize(size);
+	}
+}
+
+int LocalTransportHub::getSize() const
+{
+	return size;
+}
+
+LocalTransport::LocalTransport(LocalTransportHub* hub, int rank)
+{
+	this->hub = hub;
+	this->rank = rank;
+}
+
+int LocalTransport::getRank() const
+{
+	return rank;
+}
+
+int LocalTransport::getSize() const
+{
+	return hub->getSize();
+}
+
+void LocalTransport::send(int to, std::vector<int>& data)
+{
+	LocalTransportHub::Mailbox& mailbox = hub->mailboxes[to];
+	{
+		std::lock_guard<std::mutex> lock(mailbox.mutex);
+		//copying, the sender keeps its vector
+		mailbox.messages[rank].push_back(data);
+	}
+	mailbox.arrived.notify_all();
+}
+
+bool LocalTransport::receive(int from, std::vector<int>& data)
+{
+	LocalTransportHub::Mailbox& mailbox = hub->mailboxes[rank];
+	std::unique_lock<std::mutex> lock(mailbox.mutex);
+	std::deque<std::vector<int>>& queue = mailbox.messages[from];
+	mailbox.arrived.wait(lock, [&queue]() { return !queue.empty(); });
+	data.swap(queue.front());
+	queue.pop_front();
+	return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Transport.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+//mailboxes shared by workers running as threads of one process
+class LocalTransportHub
+{
+public:
+	explicit LocalTransportHub(int size);
+
+	int getSize() const;
+
+private:
+	friend class LocalTransport;
+
+	struct Mailbox
+	{
+		std::mutex mutex;
+		std::condition_variable arrived;
+		//messages from every sender, each in its own queue to keep the order per sender
+		std::vector<std::deque<std::vector<int>>> messages;
+	};
+
+	int size;
+	std::vector<Mailbox> mailboxes;
+};
+
+//transport between threads, works everywhere
+class LocalTransport : public Transport
+{
+public:
+	LocalTransport(LocalTransportHub* hub, int rank);
+
+	virtual int getRank() const;
+	virtual int getSize() const;
+	virtual void send(int to, std::vector<int>& data);
+	virtual bool receive(int from, std::vector<int>& data);
+
+private:
+	LocalTransportHub* hub;
+	int rank;
+};
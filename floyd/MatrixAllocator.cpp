@@ -0,0 +1,256 @@
+#include "MatrixAllocator.h"
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sched.h>
+#include <vector>
+#endif
+
+//usual size of a huge page on x86
+#define HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+//rows are padded to a multiple of this count of ints so every row starts on its own cache line
+#define ROW_ALIGNMENT 16
+//heap blocks are aligned to a cache line too, rows of small matrices live in them
+#define BLOCK_ALIGNMENT std::align_val_t(ROW_ALIGNMENT * sizeof(int))
+
+namespace
+{
+	//lies right before the array of row pointers we give out
+	struct Allocation
+	{
+		//block as the system gave it, to give it back
+		void* memory;
+		size_t size;
+		MatrixAllocator::Pages pages;
+		int verticesCount;
+		int rowLength;
+	};
+
+	Allocation* allocationOf(int** matrix)
+	{
+		return reinterpret_cast<Allocation*>(matrix) - 1;
+	}
+
+	size_t roundUp(size_t size, size_t alignment)
+	{
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+#ifdef _WIN32
+	void* allocateBlock(size_t& size, MatrixAllocator::Pages& pages)
+	{
+		if (pages == MatrixAllocator::ExplicitHugePages)
+		{
+			//large pages need a privilege most accounts don't have, then it just fails
+			size_t largePage = GetLargePageMinimum();
+			if (largePage > 0)
+			{
+				size_t largeSize = roundUp(size, largePage);
+				void* memory = VirtualAlloc(nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+				if (memory != nullptr)
+				{
+					size = largeSize;
+					return memory;
+				}
+			}
+		}
+		//there's nothing like transparent huge pages on Windows
+		pages = MatrixAllocator::NormalPages;
+		//committed pages get physical memory on the first touch, just like on Linux
+		return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+
+	void releaseBlock(void* memory, size_t)
+	{
+		VirtualFree(memory, 0, MEM_RELEASE);
+	}
+#else
+	void* allocateBlock(size_t& size, MatrixAllocator::Pages& pages)
+	{
+		if (pages == MatrixAllocator::ExplicitHugePages)
+		{
+			size_t hugeSize = roundUp(size, HUGE_PAGE_SIZE);
+			void* memory = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (memory != MAP_FAILED)
+			{
+				size = hugeSize;
+				return memory;
+			}
+			//no reserved huge pages, transparent ones are the next best thing
+			pages = MatrixAllocator::TransparentHugePages;
+		}
+		if (pages == MatrixAllocator::TransparentHugePages)
+		{
+			//the block should start on a huge page border, so we take more and give back the edges
+			size_t hugeSize = roundUp(size, HUGE_PAGE_SIZE);
+			void* memory = mmap(nullptr, hugeSize + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (memory != MAP_FAILED)
+			{
+				char* start = static_cast<char*>(memory);
+				char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<size_t>(start), HUGE_PAGE_SIZE));
+				if (aligned > start)
+					munmap(start, aligned - start);
+				char* end = start + hugeSize + HUGE_PAGE_SIZE;
+				if (end > aligned + hugeSize)
+					munmap(aligned + hugeSize, end - (aligned + hugeSize));
+#ifdef MADV_HUGEPAGE
+				if (madvise(aligned, hugeSize, MADV_HUGEPAGE) == 0)
+				{
+					size = hugeSize;
+					return aligned;
+				}
+#endif
+				//the kernel doesn't know about huge pages, it's a normal block then
+				pages = MatrixAllocator::NormalPages;
+				size = hugeSize;
+				return aligned;
+			}
+			pages = MatrixAllocator::NormalPages;
+		}
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return memory == MAP_FAILED ? nullptr : memory;
+	}
+
+	void releaseBlock(void* memory, size_t size)
+	{
+		munmap(memory, size);
+	}
+#endif
+}
+
+int** MatrixAllocator::allocate(int verticesCount, Pages pages)
+{
+	int rowLength = (int)roundUp(verticesCount, ROW_ALIGNMENT);
+	size_t size = (size_t)rowLength * verticesCount * sizeof(int);
+	//small matrices come from the heap together with row pointers:
+	//asking the system for pages of their own costs more than solving them
+	bool isSmall = size < HUGE_PAGE_SIZE;
+	size_t headerSize = sizeof(Allocation) + verticesCount * sizeof(int*);
+	size_t dataOffset = roundUp(headerSize, ROW_ALIGNMENT * sizeof(int));
+
+	void* memory = nullptr;
+	if (isSmall)
+	{
+		pages = NormalPages;
+	}
+	else
+	{
+		memory = allocateBlock(size, pages);
+		//out of memory, the same thing new would do
+		if (memory == nullptr)
+			throw std::bad_alloc();
+	}
+
+	//row pointers go right after the allocation info
+	void* header = ::operator new(isSmall ? dataOffset + size : headerSize, BLOCK_ALIGNMENT);
+	Allocation* allocation = static_cast<Allocation*>(header);
+	//nothing to give back separately for small ones
+	allocation->memory = memory;
+	allocation->size = size;
+	allocation->pages = pages;
+	allocation->verticesCount = verticesCount;
+	allocation->rowLength = rowLength;
+	if (isSmall)
+		memory = static_cast<char*>(header) + dataOffset;
+	int** matrix = reinterpret_cast<int**>(allocation + 1);
+	for (int i = 0; i < verticesCount; i++)
+		matrix[i] = static_cast<int*>(memory) + (size_t)i * rowLength;
+	return matrix;
+}
+
+void MatrixAllocator::release(int** matrix)
+{
+	if (matrix == nullptr)
+		return;
+	Allocation* allocation = allocationOf(matrix);
+	if (allocation->memory != nullptr)
+		releaseBlock(allocation->memory, allocation->size);
+	::operator delete(allocation, BLOCK_ALIGNMENT);
+}
+
+MatrixAllocator::Pages MatrixAllocator::getPages(int** matrix)
+{
+	return allocationOf(matrix)->pages;
+}
+
+#ifdef _WIN32
+int MatrixAllocator::getCurrentNode()
+{
+	UCHAR node;
+	if (!GetNumaProcessorNode((UCHAR)GetCurrentProcessorNumber(), &node) || node == 0xFF)
+		return -1;
+	return node;
+}
+
+long long MatrixAllocator::countBytesOutsideNode(int**, int, int, int)
+{
+	return -1;
+}
+
+bool MatrixAllocator::pinCurrentThread(int processor)
+{
+	if (processor < 0 || processor >= (int)(sizeof(DWORD_PTR) * 8))
+		return false;
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << processor) != 0;
+}
+#else
+int MatrixAllocator::getCurrentNode()
+{
+#ifdef SYS_getcpu
+	unsigned int processor, node;
+	if (syscall(SYS_getcpu, &processor, &node, nullptr) == 0)
+		return (int)node;
+#endif
+	return -1;
+}
+
+long long MatrixAllocator::countBytesOutsideNode(int** matrix, int firstRow, int lastRow, int node)
+{
+#ifdef SYS_move_pages
+	if (node < 0)
+		return -1;
+	Allocation* allocation = allocationOf(matrix);
+	if (firstRow >= lastRow)
+		return 0;
+	//move_pages with no target nodes only tells where pages are
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t start = reinterpret_cast<size_t>(matrix[firstRow]) / pageSize * pageSize;
+	size_t end = reinterpret_cast<size_t>(matrix[lastRow - 1] + allocation->rowLength);
+	std::vector<void*> pages;
+	for (size_t page = start; page < end; page += pageSize)
+		pages.push_back(reinterpret_cast<void*>(page));
+	std::vector<int> nodes(pages.size());
+	if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, nodes.data(), 0) != 0)
+		return -1;
+	long long bytes = 0;
+	for (unsigned int p = 0; p < nodes.size(); p++)
+	{
+		//negative is an error code, e.g. for a page nobody has touched
+		if (nodes[p] >= 0 && nodes[p] != node)
+			bytes += pageSize;
+	}
+	return bytes;
+#else
+	return -1;
+#endif
+}
+
+bool MatrixAllocator::pinCurrentThread(int processor)
+{
+#ifdef __linux__
+	if (processor < 0 || processor >= CPU_SETSIZE)
+		return false;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(processor, &set);
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+
+//allocates V x V matrices as int** (the way the rest of code uses them),
+//but with all rows in one block of memory which can be backed by huge pages.
+//the memory isn't touched here: pages are placed on the NUMA node of the thread
+//which writes them first, so whoever owns rows should be the one to fill them up.
+//anything the system refuses falls back to normal pages, so it's always safe to ask.
+class MatrixAllocator
+{
+public:
+	enum Pages
+	{
+		NormalPages,
+		TransparentHugePages, //asks the kernel to back the block with huge pages when it can (Linux)
+		ExplicitHugePages //reserved huge pages (hugetlbfs on Linux, large pages on Windows), normal if there are none
+	};
+
+	//matrices smaller than a huge page always get normal pages (from the heap)
+	static int** allocate(int verticesCount, Pages pages = TransparentHugePages);
+	//frees matrix made by allocate()
+	static void release(int** matrix);
+	//pages the matrix has really got
+	static Pages getPages(int** matrix);
+
+	//NUMA node the calling thread runs on, -1 if it's unknown
+	static int getCurrentNode();
+	//how many bytes of rows from firstRow to lastRow lie on other nodes than the given one.
+	//-1 if the system can't tell. Pages nobody has touched yet are not counted
+	static long long countBytesOutsideNode(int** matrix, int firstRow, int lastRow, int node);
+	//binds calling thread to the given processor, false if it's not possible
+	static bool pinCurrentThread(int processor);
+};
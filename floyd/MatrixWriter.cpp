@@ -0,0 +1,219 @@
+#include "MatrixWriter.h"
+#include "ParallelFor.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <limits.h>
+#ifdef FLOYD_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#define infinity INT_MAX
+
+namespace
+{
+	//two digits at once, so there are half as many divisions
+	const char digitPairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+}
+
+MatrixWriter::MatrixWriter(int threadsCount, bool isCompressed)
+{
+	this->threadsCount = threadsCount;
+	this->isCompressed = isCompressed;
+	this->bandRows = 0;
+	this->bytesCount = 0;
+}
+
+bool MatrixWriter::canCompress()
+{
+#ifdef FLOYD_WITH_ZLIB
+	return true;
+#else
+	return false;
+#endif
+}
+
+char* MatrixWriter::writeNumber(char* output, int value)
+{
+	if (value == infinity)
+	{
+		memcpy(output, "inf", 3);
+		return output + 3;
+	}
+	//made unsigned before negating, so INT_MIN is fine too
+	unsigned int rest = (unsigned int)value;
+	if (value < 0)
+	{
+		*output++ = '-';
+		rest = 0u - rest;
+	}
+	//digits go from the end of a small buffer
+	char digits[10];
+	char* start = digits + 10;
+	while (rest >= 100)
+	{
+		start -= 2;
+		memcpy(start, digitPairs + (rest % 100) * 2, 2);
+		rest /= 100;
+	}
+	if (rest >= 10)
+	{
+		start -= 2;
+		memcpy(start, digitPairs + rest * 2, 2);
+	}
+	else
+		*--start = (char)('0' + rest);
+	size_t length = digits + 10 - start;
+	memcpy(output, start, length);
+	return output + length;
+}
+
+void MatrixWriter::formatBand(int** matrix, int verticesCount, int firstRow, int lastRow, Band& output) const
+{
+	//every number with a separator takes 12 chars at most, plus the count line for the first band
+	size_t capacity = (size_t)(lastRow - firstRow) * verticesCount * 12 + 16;
+	if (output.text.size() < capacity)
+		output.text.resize(capacity);
+	char* start = output.text.data();
+	char* current = start;
+	if (firstRow == 0)
+	{
+		current = writeNumber(current, verticesCount);
+		*current++ = '\n';
+	}
+	for (int i = firstRow; i < lastRow; i++)
+	{
+		const int* row = matrix[i];
+		for (int j = 0; j < verticesCount; j++)
+		{
+			current = writeNumber(current, row[j]);
+			*current++ = ' ';
+		}
+		//the last space becomes the end of line
+		current[-1] = '\n';
+	}
+	output.size = current - start;
+}
+
+bool MatrixWriter::packBand(Band& output) const
+{
+#ifdef FLOYD_WITH_ZLIB
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	//15 bits window + 16 is gzip wrapper instead of zlib one. Fastest level, it's still several times smaller
+	if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+	size_t capacity = deflateBound(&stream, (uLong)output.size);
+	if (output.packed.size() < capacity)
+		output.packed.resize(capacity);
+	stream.next_in = (Bytef*)output.text.data();
+	stream.avail_in = (uInt)output.size;
+	stream.next_out = (Bytef*)output.packed.data();
+	stream.avail_out = (uInt)capacity;
+	int result = deflate(&stream, Z_FINISH);
+	output.size = stream.total_out;
+	deflateEnd(&stream);
+	return result == Z_STREAM_END;
+#else
+	(void)output;
+	return false;
+#endif
+}
+
+bool MatrixWriter::write(const char* fileName, int** matrix, int verticesCount)
+{
+	bytesCount = 0;
+	if (isCompressed && !canCompress())
+		return false;
+	FILE* file = nullptr;
+#ifdef _MSC_VER
+	//plain fopen is deprecated there and SDL checks make it an error
+	if (fopen_s(&file, fileName, "wb") != 0)
+		file = nullptr;
+#else
+	file = fopen(fileName, "wb");
+#endif
+	if (file == nullptr)
+		return false;
+	//bands are written whole, so stdio buffer would only copy them once more
+	setvbuf(file, nullptr, _IONBF, 0);
+
+	int formattersCount = threadsCount > 0 ? threadsCount : (int)std::thread::hardware_concurrency();
+	if (formattersCount < 1)
+		formattersCount = 1;
+	//about a megabyte of text in a band
+	int rows = bandRows > 0 ? bandRows : std::max(1, (1 << 20) / (verticesCount * 6 + 1));
+	int bandsCount = std::max(1, (verticesCount + rows - 1) / rows);
+	if (formattersCount > bandsCount)
+		formattersCount = bandsCount;
+
+	//bands are formatted ahead of writing only within this window, so memory stays bounded
+	std::vector<Band> bands(2 * formattersCount);
+	for (unsigned int b = 0; b < bands.size(); b++)
+		bands[b].index = -1;
+	std::mutex mutex;
+	std::condition_variable changed;
+	int writtenCount = 0;
+	int nextBand = 0;
+	bool isFailed = false;
+
+	//worker 0 writes, the rest format
+	parallelFor(formattersCount + 1, [&](int worker)
+	{
+		if (worker == 0)
+		{
+			for (int band = 0; band < bandsCount; band++)
+			{
+				Band& ready = bands[band % bands.size()];
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					changed.wait(lock, [&]() { return ready.index == band || isFailed; });
+					if (isFailed)
+						return;
+				}
+				const std::vector<char>& data = isCompressed ? ready.packed : ready.text;
+				size_t writtenSize = fwrite(data.data(), 1, ready.size, file);
+				bool isWritten = writtenSize == ready.size;
+				//only what has really got to the file, even if the disk is full
+				bytesCount += writtenSize;
+				std::lock_guard<std::mutex> lock(mutex);
+				ready.index = -1;
+				writtenCount = band + 1;
+				isFailed = !isWritten;
+				changed.notify_all();
+				if (isFailed)
+					return;
+			}
+			return;
+		}
+		while (true)
+		{
+			int band;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				band = nextBand++;
+				if (band >= bandsCount)
+					return;
+				//waiting until the band which had this place before is written
+				changed.wait(lock, [&]() { return band < writtenCount + (int)bands.size() || isFailed; });
+				if (isFailed)
+					return;
+			}
+			Band& output = bands[band % bands.size()];
+			formatBand(matrix, verticesCount, band * rows, std::min((band + 1) * rows, verticesCount), output);
+			bool isPacked = !isCompressed || packBand(output);
+			std::lock_guard<std::mutex> lock(mutex);
+			output.index = band;
+			isFailed = isFailed || !isPacked;
+			changed.notify_all();
+		}
+	}, formattersCount + 1);
+
+	bool isClosed = fclose(file) == 0;
+	return !isFailed && isClosed;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+
+//writes a matrix as text the way input.txt looks (count of vertices, then rows, "inf" for infinity),
+//so solved matrices can be loaded back. Rows are formatted by bands on several threads
+//while the calling thread writes ready bands to the file in order with big writes.
+//with FLOYD_WITH_ZLIB defined it can write gzip instead: every band is packed by its thread
+//as a separate gzip member, and members one after another are a valid gzip file.
+class MatrixWriter
+{
+public:
+	MatrixWriter(int threadsCount = 0, bool isCompressed = false);
+
+	//false if the file couldn't be written or compression isn't there
+	bool write(const char* fileName, int** matrix, int verticesCount);
+
+	//whether it's built with zlib
+	static bool canCompress();
+
+	//formatting threads, all hardware threads if 0
+	int threadsCount;
+	bool isCompressed;
+	//rows in one band, picked by size of matrix if 0
+	int bandRows;
+	//bytes written to the file by the last write
+	long long bytesCount;
+
+	//writes value as text and returns where it ends. Up to 11 chars
+	static char* writeNumber(char* output, int value);
+
+private:
+	//text of a band, and its gzip member if it's compressed
+	struct Band
+	{
+		std::vector<char> text;
+		std::vector<char> packed;
+		size_t size;
+		//band which is in here now, -1 when it's free
+		int index;
+	};
+
+	void formatBand(int** matrix, int verticesCount, int firstRow, int lastRow, Band& output) const;
+	bool packBand(Band& output) const;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <thread>
+#include <atomic>
+#include <vector>
+
+//calls body(index) for every index from 0 to count - 1 using all hardware threads
+//(or given count of them). Indices are handed out one by one from a shared counter,
+//so pieces of work of different size are spread evenly.
+//body must be safe to call from several threads at once.
+template <typename Body>
+void parallelFor(int count, Body body, int threadsCount = 0)
+{
+	if (threadsCount <= 0)
+		threadsCount = (int)std::thread::hardware_concurrency();
+	if (threadsCount > count)
+		threadsCount = count;
+	//nothing to parallelize, let's not spend time on starting threads
+	if (threadsCount <= 1)
+	{
+		for (int index = 0; index < count; index++)
+			body(index);
+		return;
+	}
+
+	std::atomic<int> next(0);
+	auto worker = [&]()
+	{
+		for (int index = next++; index < count; index = next++)
+			body(index);
+	};
+	std::vector<std::thread> threads;
+	//current thread works too
+	for (int t = 1; t < threadsCount; t++)
+		threads.push_back(std::thread(worker));
+	worker();
+	for (unsigned int t = 0; t < threads.size(); t++)
+		threads[t].join();
+}
@@ -0,0 +1,43 @@
+#include "ReorderedFloydSolver.h"
+
+ReorderedFloydSolver::ReorderedFloydSolver(int** adjacencyMatrix, int verticesCount, VertexOrdering::Method method,
+	FloydSolver* (*createEngine)(int** adjacencyMatrix, int verticesCount))
+	: FloydSolver(adjacencyMatrix, verticesCount)
+{
+	this->method = method;
+	this->createEngine = createEngine;
+	this->ordering = nullptr;
+}
+
+ReorderedFloydSolver::~ReorderedFloydSolver()
+{
+	delete ordering;
+}
+
+void ReorderedFloydSolver::solve()
+{
+	delete ordering;
+	ordering = new VertexOrdering(adjacencyMatrix, verticesCount, method);
+	int** permuted = ordering->createPermutedMatrix(adjacencyMatrix);
+	FloydSolver* engine = createEngine(permuted, verticesCount);
+	engine->solve();
+
+	//cell (p, q) of the engine is the cell of vertices at positions p and q,
+	//and predecessors are positions too
+	const std::vector<int>& order = ordering->order;
+	for (int p = 0; p < verticesCount; p++)
+	{
+		int* distances = distancesMatrix[order[p]];
+		int* predecessors = predecessorsMatrix[order[p]];
+		const int* engineDistances = engine->distancesMatrix[p];
+		const int* enginePredecessors = engine->predecessorsMatrix[p];
+		for (int q = 0; q < verticesCount; q++)
+		{
+			distances[order[q]] = engineDistances[q];
+			predecessors[order[q]] = enginePredecessors[q] == -1 ? -1 : order[enginePredecessors[q]];
+		}
+	}
+
+	delete engine;
+	VertexOrdering::deleteMatrix(permuted, verticesCount);
+}
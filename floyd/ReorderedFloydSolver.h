@@ -0,0 +1,25 @@
+#pragma once
+#include "FloydSolver.h"
+#include "VertexOrdering.h"
+
+//runs another engine on the matrix with vertices permuted by VertexOrdering
+//and puts the result back in the original order. Matrices, getPath and predecessors
+//speak original indices, so it's used as any other engine.
+class ReorderedFloydSolver : public FloydSolver
+{
+public:
+	//createEngine makes the engine for the permuted matrix (a lambda without captures will do)
+	ReorderedFloydSolver(int** adjacencyMatrix, int verticesCount, VertexOrdering::Method method,
+		FloydSolver* (*createEngine)(int** adjacencyMatrix, int verticesCount));
+	virtual ~ReorderedFloydSolver();
+
+	//ordering, solving the permuted matrix and mapping the result back
+	virtual void solve();
+
+	VertexOrdering::Method method;
+	//ordering made by the last solve()
+	VertexOrdering* ordering;
+
+private:
+	FloydSolver* (*createEngine)(int** adjacencyMatrix, int verticesCount);
+};
@@ -0,0 +1,242 @@
+#include "SccFloydSolver.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+SccFloydSolver::SccFloydSolver(int** adjacencyMatrix, int verticesCount)
+	: FloydSolver(adjacencyMatrix, verticesCount)
+{
+	componentsCount = 0;
+}
+
+void SccFloydSolver::solve()
+{
+	//edges of the graph as lists, we'll need to walk them more than once
+	std::vector<std::vector<int>> edges(verticesCount);
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (i != j && adjacencyMatrix[i][j] != infinity)
+				edges[i].push_back(j);
+		}
+	}
+
+	findComponents(edges);
+	componentsCount = (int)components.size();
+
+	//edges going out of every component
+	exitEdges.assign(componentsCount, std::vector<std::pair<int, int>>());
+	for (int x = 0; x < verticesCount; x++)
+	{
+		for (unsigned int e = 0; e < edges[x].size(); e++)
+		{
+			int y = edges[x][e];
+			if (componentOf[x] != componentOf[y])
+				exitEdges[componentOf[x]].push_back(std::make_pair(x, y));
+		}
+	}
+
+	//components don't share any cells, so they're solved all at once
+	parallelFor(componentsCount, [this](int component) { solveComponent(component); });
+
+	//a component can be combined when everything reachable from it is done.
+	//the level of component is the longest way to a sink, so components of one level
+	//don't depend on each other. Tarjan gives sinks first, so levels of successors are known
+	std::vector<int> levelOf(componentsCount, 0);
+	std::vector<std::vector<int>> levels(1);
+	for (int c = 0; c < componentsCount; c++)
+	{
+		for (unsigned int e = 0; e < exitEdges[c].size(); e++)
+			levelOf[c] = std::max(levelOf[c], levelOf[componentOf[exitEdges[c][e].second]] + 1);
+		if (levelOf[c] >= (int)levels.size())
+			levels.resize(levelOf[c] + 1);
+		levels[levelOf[c]].push_back(c);
+	}
+	reachable.assign(componentsCount, std::vector<int>());
+	for (unsigned int level = 0; level < levels.size(); level++)
+	{
+		const std::vector<int>& current = levels[level];
+		parallelFor((int)current.size(), [this, &current](int index) { combineComponent(current[index]); });
+	}
+}
+
+void SccFloydSolver::findComponents(const std::vector<std::vector<int>>& edges)
+{
+	components.clear();
+	componentOf.assign(verticesCount, -1);
+
+	//order in which vertices were discovered and the lowest one reachable back from them
+	std::vector<int> index(verticesCount, -1);
+	std::vector<int> lowLink(verticesCount, 0);
+	std::vector<bool> isOnStack(verticesCount, false);
+	std::vector<int> stack;
+	//instead of recursion we keep vertice and the next edge to look at
+	std::vector<std::pair<int, unsigned int>> callStack;
+	int counter = 0;
+
+	for (int start = 0; start < verticesCount; start++)
+	{
+		if (index[start] != -1)
+			continue;
+		index[start] = lowLink[start] = counter++;
+		stack.push_back(start);
+		isOnStack[start] = true;
+		callStack.push_back(std::make_pair(start, 0u));
+
+		while (!callStack.empty())
+		{
+			int v = callStack.back().first;
+			unsigned int& edge = callStack.back().second;
+			if (edge < edges[v].size())
+			{
+				int w = edges[v][edge++];
+				if (index[w] == -1)
+				{
+					//going deeper
+					index[w] = lowLink[w] = counter++;
+					stack.push_back(w);
+					isOnStack[w] = true;
+					callStack.push_back(std::make_pair(w, 0u));
+				}
+				else if (isOnStack[w])
+				{
+					lowLink[v] = std::min(lowLink[v], index[w]);
+				}
+				continue;
+			}
+
+			//all edges of v are seen, going back
+			callStack.pop_back();
+			if (lowLink[v] == index[v])
+			{
+				//v is the root of a component, everything above it on the stack belongs to it
+				int component = (int)components.size();
+				components.push_back(std::vector<int>());
+				int w;
+				do
+				{
+					w = stack.back();
+					stack.pop_back();
+					isOnStack[w] = false;
+					componentOf[w] = component;
+					components[component].push_back(w);
+				} while (w != v);
+			}
+			if (!callStack.empty())
+			{
+				int parent = callStack.back().first;
+				lowLink[parent] = std::min(lowLink[parent], lowLink[v]);
+			}
+		}
+	}
+}
+
+void SccFloydSolver::solveComponent(int component)
+{
+	const std::vector<int>& vertices = components[component];
+	int size = (int)vertices.size();
+	//single vertice has nothing to solve
+	if (size == 1)
+		return;
+
+	//copying the component to a compact local matrix so it's solved in cache
+	//(predecessors stay global indices)
+	std::vector<int> distances(size * size);
+	std::vector<int> predecessors(size * size);
+	for (int i = 0; i < size; i++)
+	{
+		for (int j = 0; j < size; j++)
+		{
+			distances[i * size + j] = distancesMatrix[vertices[i]][vertices[j]];
+			predecessors[i * size + j] = predecessorsMatrix[vertices[i]][vertices[j]];
+		}
+	}
+
+	for (int k = 0; k < size; k++)
+	{
+		const int* distancesK = &distances[k * size];
+		const int* predecessorsK = &predecessors[k * size];
+		for (int i = 0; i < size; i++)
+		{
+			int distanceIK = distances[i * size + k];
+			if (distanceIK == infinity)
+				continue;
+			int* distancesI = &distances[i * size];
+			int* predecessorsI = &predecessors[i * size];
+			for (int j = 0; j < size; j++)
+			{
+				if (distancesK[j] != infinity && distanceIK + distancesK[j] < distancesI[j])
+				{
+					distancesI[j] = distanceIK + distancesK[j];
+					predecessorsI[j] = predecessorsK[j];
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < size; i++)
+	{
+		for (int j = 0; j < size; j++)
+		{
+			distancesMatrix[vertices[i]][vertices[j]] = distances[i * size + j];
+			predecessorsMatrix[vertices[i]][vertices[j]] = predecessors[i * size + j];
+		}
+	}
+}
+
+void SccFloydSolver::combineComponent(int component)
+{
+	const std::vector<int>& vertices = components[component];
+	const std::vector<std::pair<int, int>>& exits = exitEdges[component];
+
+	//everything reachable through exit edges: target components and what's reachable from them
+	std::vector<int>& targets = reachable[component];
+	for (unsigned int e = 0; e < exits.size(); e++)
+	{
+		int next = componentOf[exits[e].second];
+		targets.insert(targets.end(), components[next].begin(), components[next].end());
+		targets.insert(targets.end(), reachable[next].begin(), reachable[next].end());
+	}
+	std::sort(targets.begin(), targets.end());
+	targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+	//shortest path from u outside the component starts with a path to some x inside it,
+	//then goes by exit edge x->y, and then by the shortest path from y which is already known
+	for (unsigned int n = 0; n < vertices.size(); n++)
+	{
+		int u = vertices[n];
+		int* distancesU = distancesMatrix[u];
+		int* predecessorsU = predecessorsMatrix[u];
+		for (unsigned int e = 0; e < exits.size(); e++)
+		{
+			int x = exits[e].first;
+			int y = exits[e].second;
+			int distanceUY = distancesU[x] + adjacencyMatrix[x][y];
+			if (x == u)
+				distanceUY = adjacencyMatrix[x][y];
+			//distances from y are finite exactly for its component and what it reaches
+			int next = componentOf[y];
+			const int* distancesY = distancesMatrix[y];
+			const int* predecessorsY = predecessorsMatrix[y];
+			for (int part = 0; part < 2; part++)
+			{
+				const std::vector<int>& list = part == 0 ? components[next] : reachable[next];
+				for (unsigned int t = 0; t < list.size(); t++)
+				{
+					int v = list[t];
+					int distance = distanceUY + distancesY[v];
+					if (v == y)
+						distance = distanceUY;
+					if (distance < distancesU[v])
+					{
+						distancesU[v] = distance;
+						predecessorsU[v] = v == y ? x : predecessorsY[v];
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "FloydSolver.h"
+#include <vector>
+
+//solves all pairs by strongly connected components.
+//a shortest path between two vertices of one component never leaves it,
+//so every component is solved by Floyd algorithm on its own (in parallel).
+//then components are combined along the condensation DAG, from sinks to sources:
+//a path leaving component C goes through one of its exit edges x->y and continues
+//with the already known distances from y. Pairs with no path are never touched.
+class SccFloydSolver : public FloydSolver
+{
+public:
+	SccFloydSolver(int** adjacencyMatrix, int verticesCount);
+
+	virtual void solve();
+
+	//count of components found by the last solve()
+	int componentsCount;
+
+private:
+	//finds strongly connected components with iterative Tarjan algorithm.
+	//components come out in reverse topological order (sinks first)
+	void findComponents(const std::vector<std::vector<int>>& edges);
+	//Floyd algorithm inside one component
+	void solveComponent(int component);
+	//distances from vertices of a component to everything reachable outside of it
+	void combineComponent(int component);
+
+	//vertices of every component
+	std::vector<std::vector<int>> components;
+	//component of every vertice
+	std::vector<int> componentOf;
+	//edges x->y leaving every component, as pairs of x and y
+	std::vector<std::vector<std::pair<int, int>>> exitEdges;
+	//vertices outside of every component reachable from it
+	std::vector<std::vector<int>> reachable;
+};
@@ -0,0 +1,176 @@
+#include "SocketTransport.h"
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+//read and write can do only a part of the job, so we're repeating them
+static bool writeAll(int socket, const char* data, size_t length)
+{
+	while (length > 0)
+	{
+		ssize_t written = ::send(socket, data, length, MSG_NOSIGNAL);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return false;
+		data += written;
+		length -= written;
+	}
+	return true;
+}
+
+static bool readAll(int socket, char* data, size_t length)
+{
+	while (length > 0)
+	{
+		ssize_t received = ::read(socket, data, length);
+		if (received < 0 && errno == EINTR)
+			continue;
+		if (received <= 0)
+			return false;
+		data += received;
+		length -= received;
+	}
+	return true;
+}
+
+bool SocketTransport::createMesh(int size, std::vector<std::vector<int>>& sockets)
+{
+	sockets.assign(size, std::vector<int>(size, -1));
+	for (int a = 0; a < size; a++)
+	{
+		for (int b = a + 1; b < size; b++)
+		{
+			int pair[2];
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+			{
+				closeMesh(sockets);
+				return false;
+			}
+			sockets[a][b] = pair[0];
+			sockets[b][a] = pair[1];
+		}
+	}
+	return true;
+}
+
+void SocketTransport::closeMesh(std::vector<std::vector<int>>& sockets)
+{
+	for (unsigned int a = 0; a < sockets.size(); a++)
+	{
+		for (unsigned int b = 0; b < sockets[a].size(); b++)
+		{
+			if (sockets[a][b] != -1)
+				close(sockets[a][b]);
+			sockets[a][b] = -1;
+		}
+	}
+}
+
+SocketTransport::SocketTransport(std::vector<std::vector<int>>& sockets, int rank)
+{
+	this->rank = rank;
+	this->size = (int)sockets.size();
+	//other ranks' ends are not ours to keep open
+	for (int a = 0; a < size; a++)
+	{
+		for (int b = 0; b < size; b++)
+		{
+			if (a != rank && sockets[a][b] != -1)
+			{
+				close(sockets[a][b]);
+				sockets[a][b] = -1;
+			}
+		}
+	}
+	peers.resize(size);
+	for (int to = 0; to < size; to++)
+	{
+		if (to == rank)
+			continue;
+		peers[to].reset(new Peer());
+		peers[to]->socket = sockets[rank][to];
+		peers[to]->isClosing = false;
+		peers[to]->sender = std::thread(&SocketTransport::sendLoop, peers[to].get());
+	}
+}
+
+SocketTransport::~SocketTransport()
+{
+	for (int to = 0; to < size; to++)
+	{
+		if (!peers[to])
+			continue;
+		{
+			std::lock_guard<std::mutex> lock(peers[to]->mutex);
+			peers[to]->isClosing = true;
+		}
+		peers[to]->hasWork.notify_one();
+		peers[to]->sender.join();
+		close(peers[to]->socket);
+	}
+}
+
+int SocketTransport::getRank() const
+{
+	return rank;
+}
+
+int SocketTransport::getSize() const
+{
+	return size;
+}
+
+void SocketTransport::send(int to, std::vector<int>& data)
+{
+	Peer* peer = peers[to].get();
+	{
+		std::lock_guard<std::mutex> lock(peer->mutex);
+		peer->outgoing.push_back(data);
+	}
+	peer->hasWork.notify_one();
+}
+
+bool SocketTransport::receive(int from, std::vector<int>& data)
+{
+	//every message is its length in ints followed by the ints themselves
+	uint64_t length;
+	int socket = peers[from]->socket;
+	if (!readAll(socket, (char*)&length, sizeof(length)))
+		return false;
+	data.resize((size_t)length);
+	return readAll(socket, (char*)data.data(), (size_t)length * sizeof(int));
+}
+
+void SocketTransport::sendLoop(Peer* peer)
+{
+	bool isBroken = false;
+	while (true)
+	{
+		std::vector<int> message;
+		{
+			std::unique_lock<std::mutex> lock(peer->mutex);
+			peer->hasWork.wait(lock, [peer]() { return peer->isClosing || !peer->outgoing.empty(); });
+			if (peer->outgoing.empty())
+				return;
+			message.swap(peer->outgoing.front());
+			peer->outgoing.pop_front();
+		}
+		//if the peer is gone there's nobody to write to, we're just dropping messages
+		if (isBroken)
+			continue;
+		uint64_t length = message.size();
+		isBroken = !writeAll(peer->socket, (const char*)&length, sizeof(length))
+			|| !writeAll(peer->socket, (const char*)message.data(), message.size() * sizeof(int));
+	}
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include "Transport.h"
+
+//processes and unix sockets are not there on Windows, threads and LocalTransport are
+#ifndef _WIN32
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+//transport between processes of one host over unix domain sockets.
+//the whole mesh of socket pairs is made before forking workers,
+//then every worker takes its own ends of it.
+//sends are queued and written by a thread per peer, so send() never waits for the receiver.
+class SocketTransport : public Transport
+{
+public:
+	//makes socket pair for every two ranks. sockets[a][b] is the end rank a uses to talk to rank b.
+	//returns false if the system has refused to give sockets
+	static bool createMesh(int size, std::vector<std::vector<int>>& sockets);
+	//closes every socket of the mesh (for when workers can't be started after all)
+	static void closeMesh(std::vector<std::vector<int>>& sockets);
+
+	//takes the ends of given rank and closes all the others (they belong to other processes)
+	SocketTransport(std::vector<std::vector<int>>& sockets, int rank);
+	//writes everything queued and closes sockets
+	virtual ~SocketTransport();
+
+	virtual int getRank() const;
+	virtual int getSize() const;
+	virtual void send(int to, std::vector<int>& data);
+	virtual bool receive(int from, std::vector<int>& data);
+
+private:
+	struct Peer
+	{
+		int socket;
+		std::thread sender;
+		std::mutex mutex;
+		std::condition_variable hasWork;
+		std::deque<std::vector<int>> outgoing;
+		bool isClosing;
+	};
+
+	int rank;
+	int size;
+	std::vector<std::unique_ptr<Peer>> peers;
+
+	//writes queued messages of the peer until it's closing and the queue is empty
+	static void sendLoop(Peer* peer);
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "SourcesSolver.h"
+#include "FloydSolver.h"
+#include "DenseFloydSolver.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+SourcesSolver::SourcesSolver(int** adjacencyMatrix, int verticesCount, const std::vector<int>& sources)
+{
+	this->adjacencyMatrix = adjacencyMatrix;
+	this->verticesCount = verticesCount;
+	this->sources = sources;
+	//Dijkstra for one source takes about as long as 7 iterations of Floyd algorithm,
+	//but sources go in parallel, while Floyd algorithm here doesn't
+	this->floydRatio = 0.15 * std::max(1u, std::thread::hardware_concurrency());
+	if (this->floydRatio > 0.9)
+		this->floydRatio = 0.9;
+	this->method = Dijkstra;
+}
+
+const int* SourcesSolver::getDistances(int row) const
+{
+	return distances.data() + (size_t)row * verticesCount;
+}
+
+const int* SourcesSolver::getPredecessors(int row) const
+{
+	return predecessors.data() + (size_t)row * verticesCount;
+}
+
+void SourcesSolver::getPath(int row, int finish, std::vector<int>& path) const
+{
+	buildPath(getPredecessors(row), sources[row], finish, verticesCount, path);
+}
+
+void SourcesSolver::solve()
+{
+	int rowsCount = (int)sources.size();
+	distances.resize((size_t)rowsCount * verticesCount);
+	predecessors.resize((size_t)rowsCount * verticesCount);
+
+	bool hasNegativeWeights = false;
+	for (int i = 0; i < verticesCount && !hasNegativeWeights; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			//a negative loop is a negative cycle already, Bellman-Ford will see it as well
+			if (adjacencyMatrix[i][j] < 0)
+			{
+				hasNegativeWeights = true;
+				break;
+			}
+		}
+	}
+
+	if (rowsCount > floydRatio * verticesCount)
+	{
+		method = Floyd;
+		solveWithFloyd();
+		return;
+	}
+	potentials.assign(verticesCount, 0);
+	method = Dijkstra;
+	if (hasNegativeWeights)
+	{
+		method = Johnson;
+		//there are no shortest paths with negative cycles, Floyd algorithm gives what others give then
+		if (!findPotentials())
+		{
+			method = Floyd;
+			solveWithFloyd();
+			return;
+		}
+	}
+	parallelFor(rowsCount, [this](int row) { solveSource(row); });
+}
+
+bool SourcesSolver::findPotentials()
+{
+	//virtual vertice has zero edges to everyone, so every potential starts at zero and only goes down.
+	//Bellman-Ford with a queue: only vertices whose potential has just changed are looked at again
+	std::deque<int> queue;
+	std::vector<char> isQueued(verticesCount, 1);
+	//count of real edges on the path that gave the potential
+	std::vector<int> edgesCount(verticesCount, 0);
+	for (int v = 0; v < verticesCount; v++)
+		queue.push_back(v);
+	//every look at a vertice costs V, and V^2 / 16 of them take about as long as Floyd algorithm
+	//(which goes over rows much faster). It happens mostly when there's a negative cycle
+	long long lookupsLeft = (long long)verticesCount * verticesCount / 16 + verticesCount;
+	while (!queue.empty())
+	{
+		if (--lookupsLeft < 0)
+			return false;
+		int i = queue.front();
+		queue.pop_front();
+		isQueued[i] = 0;
+		const int* row = adjacencyMatrix[i];
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (i != j && row[j] != infinity && potentials[i] + row[j] < potentials[j])
+			{
+				potentials[j] = potentials[i] + row[j];
+				edgesCount[j] = edgesCount[i] + 1;
+				//a path of V edges goes through some vertice twice, so it has a negative cycle
+				if (edgesCount[j] >= verticesCount)
+					return false;
+				if (!isQueued[j])
+				{
+					isQueued[j] = 1;
+					queue.push_back(j);
+				}
+			}
+		}
+	}
+	//loops aren't taken above, but a negative one is a negative cycle too
+	for (int i = 0; i < verticesCount; i++)
+	{
+		if (adjacencyMatrix[i][i] < 0)
+			return false;
+	}
+	return true;
+}
+
+void SourcesSolver::solveSource(int row)
+{
+	int source = sources[row];
+	int* rowDistances = distances.data() + (size_t)row * verticesCount;
+	int* rowPredecessors = predecessors.data() + (size_t)row * verticesCount;
+	findDistances(adjacencyMatrix, verticesCount, source, false, potentials.data(), rowDistances, rowPredecessors);
+
+	//the source itself: Floyd algorithm keeps its own edge (0 usually)
+	//unless a cycle through the other vertices is shorter
+	rowDistances[source] = adjacencyMatrix[source][source];
+	rowPredecessors[source] = rowDistances[source] != infinity ? source : -1;
+	for (int u = 0; u < verticesCount; u++)
+	{
+		int edge = adjacencyMatrix[u][source];
+		if (u == source || edge == infinity || rowDistances[u] == infinity)
+			continue;
+		if (rowDistances[u] + edge < rowDistances[source])
+		{
+			rowDistances[source] = rowDistances[u] + edge;
+			rowPredecessors[source] = u;
+		}
+	}
+}
+
+void SourcesSolver::findDistances(int** adjacencyMatrix, int verticesCount, int source, bool isReversed,
+	const long long* potentials, int* distances, int* predecessors)
+{
+	//reweighted distances: weight of u->v is w + potential[u] - potential[v] >= 0
+	std::vector<long long> reweighted(verticesCount, LLONG_MAX);
+	std::vector<char> isDone(verticesCount, 0);
+	if (predecessors != nullptr)
+	{
+		for (int v = 0; v < verticesCount; v++)
+			predecessors[v] = -1;
+	}
+	reweighted[source] = 0;
+
+	for (int step = 0; step < verticesCount; step++)
+	{
+		//the closest vertice not done yet, by plain search: the matrix is dense anyway
+		int closest = -1;
+		for (int v = 0; v < verticesCount; v++)
+		{
+			if (!isDone[v] && reweighted[v] != LLONG_MAX && (closest == -1 || reweighted[v] < reweighted[closest]))
+				closest = v;
+		}
+		if (closest == -1)
+			break;
+		isDone[closest] = 1;
+		long long base = reweighted[closest] + (potentials != nullptr ? potentials[closest] : 0);
+		for (int v = 0; v < verticesCount; v++)
+		{
+			//edge closest->v, or v->closest when going backwards
+			int edge = isReversed ? adjacencyMatrix[v][closest] : adjacencyMatrix[closest][v];
+			if (isDone[v] || edge == infinity)
+				continue;
+			long long distance = base + edge - (potentials != nullptr ? potentials[v] : 0);
+			if (distance < reweighted[v])
+			{
+				reweighted[v] = distance;
+				if (predecessors != nullptr)
+					predecessors[v] = closest;
+			}
+		}
+	}
+
+	for (int v = 0; v < verticesCount; v++)
+	{
+		distances[v] = reweighted[v] == LLONG_MAX ? infinity
+			: (int)(potentials != nullptr ? reweighted[v] - potentials[source] + potentials[v] : reweighted[v]);
+	}
+}
+
+void SourcesSolver::solveWithFloyd()
+{
+	DenseFloydSolver floyd(adjacencyMatrix, verticesCount);
+	floyd.solve();
+	for (unsigned int row = 0; row < sources.size(); row++)
+	{
+		std::copy(floyd.distancesMatrix[sources[row]], floyd.distancesMatrix[sources[row]] + verticesCount, distances.data() + (size_t)row * verticesCount);
+		std::copy(floyd.predecessorsMatrix[sources[row]], floyd.predecessorsMatrix[sources[row]] + verticesCount, predecessors.data() + (size_t)row * verticesCount);
+	}
+}
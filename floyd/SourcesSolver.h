@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+
+//shortest paths from a set of sources only, when the whole matrix isn't needed.
+//every source gets Dijkstra algorithm over the adjacency matrix (O(V^2) with arrays, which is
+//the best there is for dense matrices), sources go in parallel. Negative weights are handled
+//Johnson's way: one Bellman-Ford pass gives potentials which make all weights nonnegative.
+//when there are many sources (or a negative cycle) it's just Floyd algorithm.
+//only |S| x V distances and predecessors are stored, rows go in the order sources were given.
+class SourcesSolver
+{
+public:
+	enum Method
+	{
+		Dijkstra,
+		Johnson, //Bellman-Ford potentials, then Dijkstra
+		Floyd //full Floyd algorithm, only the rows of sources are kept
+	};
+
+	SourcesSolver(int** adjacencyMatrix, int verticesCount, const std::vector<int>& sources);
+
+	void solve();
+
+	//original adjacency matrix of graph (not owned)
+	int** adjacencyMatrix;
+	int verticesCount;
+	std::vector<int> sources;
+	//Floyd algorithm is used when count of sources is more than this part of vertices
+	double floydRatio;
+	//method used by the last solve()
+	Method method;
+
+	//row of the source with given index in sources, verticesCount long,
+	//the same meaning as rows of FloydSolver matrices
+	const int* getDistances(int row) const;
+	const int* getPredecessors(int row) const;
+	//constructs path from source of the row to finish, empty if there's none
+	void getPath(int row, int finish, std::vector<int>& path) const;
+
+	//O(V^2) Dijkstra over adjacency matrix from source, or to it if isReversed (every edge is taken backwards).
+	//potentials (null if there are none) must make every edge nonnegative: w(u, v) + potentials[u] - potentials[v].
+	//distances are the real ones, infinity if there's no path, 0 from source to itself;
+	//predecessors (null if they aren't needed) are the previous vertice on the way from source
+	//(the next one on the way to it if isReversed), -1 if there's none
+	static void findDistances(int** adjacencyMatrix, int verticesCount, int source, bool isReversed,
+		const long long* potentials, int* distances, int* predecessors);
+
+private:
+	std::vector<int> distances;
+	std::vector<int> predecessors;
+	//potential of every vertice for Johnson's reweighting (zeros if weights are nonnegative)
+	std::vector<long long> potentials;
+
+	//finds potentials with Bellman-Ford from a virtual vertice connected to all others.
+	//false if there's a negative cycle or it's taking longer than Floyd algorithm would
+	bool findPotentials();
+	void solveSource(int row);
+	void solveWithFloyd();
+};
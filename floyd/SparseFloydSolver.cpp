@@ -0,0 +1,63 @@
+#include "SparseFloydSolver.h"
+#include <limits.h>
+
+#define infinity INT_MAX
+
+SparseFloydSolver::SparseFloydSolver(int** adjacencyMatrix, int verticesCount)
+	: FloydSolver(adjacencyMatrix, verticesCount)
+{
+	relaxationsCount = 0;
+}
+
+void SparseFloydSolver::solve()
+{
+	//collecting finite entries of the initial matrix
+	outNeighbours.assign(verticesCount, std::vector<int>());
+	inNeighbours.assign(verticesCount, std::vector<int>());
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (i != j && distancesMatrix[i][j] != infinity)
+			{
+				outNeighbours[i].push_back(j);
+				inNeighbours[j].push_back(i);
+			}
+		}
+	}
+
+	relaxationsCount = 0;
+	for (int k = 0; k < verticesCount; k++)
+	{
+		//without negative cycles row k and column k don't change during iteration k,
+		//so these lists stay the same while we're going through them
+		const std::vector<int>& sources = inNeighbours[k];
+		const std::vector<int>& targets = outNeighbours[k];
+		int* distancesK = distancesMatrix[k];
+		int* predecessorsK = predecessorsMatrix[k];
+		for (unsigned int s = 0; s < sources.size(); s++)
+		{
+			int i = sources[s];
+			int distanceIK = distancesMatrix[i][k];
+			int* distancesI = distancesMatrix[i];
+			int* predecessorsI = predecessorsMatrix[i];
+			for (unsigned int t = 0; t < targets.size(); t++)
+			{
+				int j = targets[t];
+				int distance = distanceIK + distancesK[j];
+				if (distance < distancesI[j])
+				{
+					//a new finite entry - both lists grow
+					if (distancesI[j] == infinity && i != j)
+					{
+						outNeighbours[i].push_back(j);
+						inNeighbours[j].push_back(i);
+					}
+					distancesI[j] = distance;
+					predecessorsI[j] = predecessorsK[j];
+				}
+			}
+			relaxationsCount += targets.size();
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "FloydSolver.h"
+#include <vector>
+
+//Floyd algorithm which only touches cells that can actually change.
+//on iteration k only pairs (i, j) with finite distance from i to k and from k to j
+//can be improved, so we keep lists of finite entries of every row and column
+//and relax only the cross product of column k and row k.
+//on disconnected or sparse graphs it's orders of magnitude less work than V^3,
+//and the output is the same dense matrices.
+class SparseFloydSolver : public FloydSolver
+{
+public:
+	SparseFloydSolver(int** adjacencyMatrix, int verticesCount);
+
+	virtual void solve();
+
+	//count of relaxations performed by the last solve() (V^3 for dense engine)
+	long long relaxationsCount;
+
+private:
+	//outNeighbours[v] - vertices with finite distance from v,
+	//inNeighbours[v] - vertices with finite distance to v (v itself excluded in both).
+	//they grow as new paths are found
+	std::vector<std::vector<int>> outNeighbours;
+	std::vector<std::vector<int>> inNeighbours;
+};
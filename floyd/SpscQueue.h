@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+//lock-free bounded queue for exactly one producer thread and one consumer thread.
+//the solver thread pushes step events into it and the render loop pops them,
+//so neither of them ever waits for a lock held by the other one.
+template <typename T>
+class SpscQueue
+{
+public:
+	//capacity is rounded up to the power of two so we can wrap indices with a mask
+	explicit SpscQueue(size_t capacity)
+	{
+		size_t size = 2;
+		while (size < capacity)
+			size *= 2;
+		buffer.resize(size);
+		mask = size - 1;
+		head = 0;
+		tail = 0;
+	}
+
+	//called by producer only. Returns false if the queue is full.
+	bool tryPush(T&& item)
+	{
+		size_t currentTail = tail.load(std::memory_order_relaxed);
+		if (currentTail - head.load(std::memory_order_acquire) > mask)
+			return false;
+		buffer[currentTail & mask] = std::move(item);
+		//publishing the element only after it is completely written
+		tail.store(currentTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	//called by consumer only. Returns false if there's nothing to pop.
+	bool tryPop(T& item)
+	{
+		size_t currentHead = head.load(std::memory_order_relaxed);
+		if (currentHead == tail.load(std::memory_order_acquire))
+			return false;
+		item = std::move(buffer[currentHead & mask]);
+		//letting producer reuse the slot only after we've moved the element out
+		head.store(currentHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	//approximate count of elements, exact only when called from one of the two threads
+	//while the other one is idle
+	size_t size() const
+	{
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+
+private:
+	std::vector<T> buffer;
+	size_t mask;
+	//head and tail are kept apart so producer and consumer
+	//don't keep stealing the same cache line from each other
+	std::atomic<size_t> head;
+	char padding[64];
+	std::atomic<size_t> tail;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include "Graph.h"
+#include <vector>
+
+//everything the renderer needs to know about one floydStep call.
+//the solver keeps mutating graph matrices while renderer is drawing,
+//so the event carries its own copy of indices, changed cell and path.
+struct StepEvent
+{
+	Graph::FloydStepResult result;
+	//indices of algorithm at the moment of the step
+	int k;
+	int i;
+	int j;
+	//distance between i and j before and after the iteration (the changed cell)
+	int oldDistance;
+	int newDistance;
+	//path to draw. For BetterPathFound it's the old (bad) path,
+	//for PathFoundAndApplied and BetterPathApplied it's the new one
+	std::vector<int> path;
+};
+
+//something the visualizer can take step events from:
+//live solver thread or a recorded trace
+class StepEventSource
+{
+public:
+	virtual ~StepEventSource() {}
+	//takes the next event if there's one
+	virtual bool pollEvent(StepEvent& event) = 0;
+};
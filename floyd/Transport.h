@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+
+//the way workers of distributed solver talk to each other.
+//every worker has a rank from 0 to size - 1. Messages between two ranks
+//arrive in the order they were sent, that's all the solver relies on.
+class Transport
+{
+public:
+	virtual ~Transport() {}
+
+	virtual int getRank() const = 0;
+	virtual int getSize() const = 0;
+
+	//sends data to the given rank. It must not wait for the receiver
+	//(the data is copied or taken, so caller can reuse the vector right away)
+	virtual void send(int to, std::vector<int>& data) = 0;
+	//waits for the next message from the given rank.
+	//returns false if the rank is gone and nothing will come anymore
+	virtual bool receive(int from, std::vector<int>& data) = 0;
+};
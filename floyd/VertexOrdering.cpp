@@ -0,0 +1,140 @@
+#include "VertexOrdering.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits.h>
+
+#define infinity INT_MAX
+
+VertexOrdering::VertexOrdering(int** adjacencyMatrix, int verticesCount, Method method)
+{
+	this->verticesCount = verticesCount;
+	this->method = method;
+
+	neighbours.assign(verticesCount, std::vector<int>());
+	if (method != Identity)
+	{
+		for (int i = 0; i < verticesCount; i++)
+		{
+			//every pair is looked at once, from the smaller index
+			for (int j = i + 1; j < verticesCount; j++)
+			{
+				if (adjacencyMatrix[i][j] != infinity || adjacencyMatrix[j][i] != infinity)
+				{
+					neighbours[i].push_back(j);
+					neighbours[j].push_back(i);
+				}
+			}
+		}
+	}
+
+	switch (method)
+	{
+	case ReverseCuthillMcKee:
+		orderBreadthFirst(true);
+		//reversing makes the profile of the matrix smaller, bandwidth stays the same
+		std::reverse(order.begin(), order.end());
+		break;
+	case BreadthFirst:
+		orderBreadthFirst(false);
+		break;
+	case Degree:
+		orderByDegree();
+		break;
+	default:
+		for (int v = 0; v < verticesCount; v++)
+			order.push_back(v);
+		break;
+	}
+	//lists are needed only to make the order
+	neighbours.clear();
+
+	positionOf.assign(verticesCount, 0);
+	for (int p = 0; p < verticesCount; p++)
+		positionOf[order[p]] = p;
+}
+
+void VertexOrdering::orderBreadthFirst(bool isByDegree)
+{
+	std::vector<bool> isVisited(verticesCount, false);
+	//vertices in order of degree to pick a start of every component
+	std::vector<int> starts(verticesCount);
+	for (int v = 0; v < verticesCount; v++)
+		starts[v] = v;
+	if (isByDegree)
+	{
+		std::stable_sort(starts.begin(), starts.end(), [this](int a, int b) { return neighbours[a].size() < neighbours[b].size(); });
+		for (int v = 0; v < verticesCount; v++)
+		{
+			std::sort(neighbours[v].begin(), neighbours[v].end(), [this](int a, int b)
+			{
+				return neighbours[a].size() < neighbours[b].size() || (neighbours[a].size() == neighbours[b].size() && a < b);
+			});
+		}
+	}
+
+	for (int s = 0; s < verticesCount; s++)
+	{
+		int start = starts[s];
+		if (isVisited[start])
+			continue;
+		//order itself is the queue of breadth first search
+		size_t head = order.size();
+		order.push_back(start);
+		isVisited[start] = true;
+		while (head < order.size())
+		{
+			int v = order[head++];
+			for (unsigned int n = 0; n < neighbours[v].size(); n++)
+			{
+				int w = neighbours[v][n];
+				if (!isVisited[w])
+				{
+					isVisited[w] = true;
+					order.push_back(w);
+				}
+			}
+		}
+	}
+}
+
+void VertexOrdering::orderByDegree()
+{
+	order.resize(verticesCount);
+	for (int v = 0; v < verticesCount; v++)
+		order[v] = v;
+	std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return neighbours[a].size() > neighbours[b].size(); });
+}
+
+int** VertexOrdering::createPermutedMatrix(int** matrix) const
+{
+	int** permuted = new int*[verticesCount];
+	for (int p = 0; p < verticesCount; p++)
+	{
+		permuted[p] = new int[verticesCount];
+		const int* row = matrix[order[p]];
+		for (int q = 0; q < verticesCount; q++)
+			permuted[p][q] = row[order[q]];
+	}
+	return permuted;
+}
+
+void VertexOrdering::deleteMatrix(int** matrix, int verticesCount)
+{
+	for (int i = 0; i < verticesCount; i++)
+		delete[] matrix[i];
+	delete[] matrix;
+}
+
+int VertexOrdering::getBandwidth(int** adjacencyMatrix) const
+{
+	int bandwidth = 0;
+	for (int i = 0; i < verticesCount; i++)
+	{
+		for (int j = 0; j < verticesCount; j++)
+		{
+			if (i != j && adjacencyMatrix[i][j] != infinity)
+				bandwidth = std::max(bandwidth, std::abs(positionOf[i] - positionOf[j]));
+		}
+	}
+	return bandwidth;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+
+//permutation of vertices which puts related vertices close to each other.
+//input files list vertices in whatever order they were exported, so on clustered graphs
+//rows of one cluster are scattered over the matrix. Solving the permuted matrix keeps
+//the rows and blocks engines touch together near each other in memory.
+//edges are taken as undirected for ordering (either i->j or j->i connects i and j)
+class VertexOrdering
+{
+public:
+	enum Method
+	{
+		Identity, //keeps the input order
+		ReverseCuthillMcKee, //breadth first from a low degree vertice, neighbours by ascending degree, reversed; keeps edges near the diagonal
+		BreadthFirst, //breadth first from the lowest index of every component; puts clusters together
+		Degree //by descending degree, hubs first
+	};
+
+	VertexOrdering(int** adjacencyMatrix, int verticesCount, Method method);
+
+	int verticesCount;
+	Method method;
+	//original vertice at every position of the permuted matrix
+	std::vector<int> order;
+	//position of every original vertice in the permuted matrix
+	std::vector<int> positionOf;
+
+	//allocates matrix (the way floyd.cpp does) with rows and columns of the given one permuted
+	int** createPermutedMatrix(int** matrix) const;
+	static void deleteMatrix(int** matrix, int verticesCount);
+
+	//the biggest distance between positions of connected vertices, the less the better
+	int getBandwidth(int** adjacencyMatrix) const;
+
+private:
+	//neighbours of every vertice, both incoming and outgoing
+	std::vector<std::vector<int>> neighbours;
+
+	void orderBreadthFirst(bool isByDegree);
+	void orderByDegree();
+};